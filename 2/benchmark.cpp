@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include "array.hpp"
+#include "decimal.hpp"
+
+namespace {
+std::string RandomDigits(size_t count, std::mt19937& gen) {
+    std::string res(count, '0');
+    for (char& ch : res) {
+        ch = static_cast<char>('0' + gen() % 10);
+    }
+    res[0] = '9';
+    return res;
+}
+
+Array::Array ToDigits(const std::string& str) {
+    Array::Array res(str.size(), 0);
+    for (size_t i = 0; i < str.size(); ++i) {
+        res.GetByIdx(i) = static_cast<unsigned char>(str[str.size() - 1 - i] - '0');
+    }
+    return res;
+}
+
+// Digit-at-a-time loops that Add/Sub used before the SSE2 kernels, kept as the baseline.
+Array::Array ScalarAdd(const Array::Array& digits1, const Array::Array& digits2) {
+    const Array::Array& big_num = digits1.Size() >= digits2.Size() ? digits1 : digits2;
+    Array::Array res(big_num.Size() + 1, 0);
+    uint8_t mem = 0;
+    size_t idx = 0;
+
+    for (; idx < std::min(digits1.Size(), digits2.Size()); ++idx) {
+        uint8_t sum = digits1.GetByIdx(idx) + digits2.GetByIdx(idx) + mem;
+        mem = sum / 10;
+        res.GetByIdx(idx) = sum % 10;
+    }
+    for (; idx < big_num.Size(); ++idx) {
+        uint8_t sum = big_num.GetByIdx(idx) + mem;
+        mem = sum / 10;
+        res.GetByIdx(idx) = sum % 10;
+    }
+    res.GetByIdx(idx) = mem;
+    return res;
+}
+
+Array::Array ScalarSub(const Array::Array& digits1, const Array::Array& digits2) {
+    Array::Array res(digits1.Size(), 0);
+    int mem = 0;
+
+    for (size_t i = 0; i < digits1.Size(); ++i) {
+        int num1 = digits1.GetByIdx(i) - mem;
+        int num2 = i < digits2.Size() ? digits2.GetByIdx(i) : 0;
+        mem = num1 < num2;
+        res.GetByIdx(i) = num1 + mem * 10 - num2;
+    }
+    return res;
+}
+
+template <typename Func>
+double Measure(Func func, int repeats) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        func();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / repeats;
+}
+}
+
+int main() {
+    const size_t digits = 1000000;
+    const int repeats = 20;
+
+    std::mt19937 gen(42);
+    const std::string big_str = RandomDigits(digits, gen);
+    const std::string small_str = RandomDigits(digits - 1, gen);
+    Decimal::Decimal big(big_str);
+    Decimal::Decimal small(small_str);
+    const Array::Array big_digits = ToDigits(big_str);
+    const Array::Array small_digits = ToDigits(small_str);
+
+    std::cout << "Operands: " << digits << " digits, " << repeats << " runs each" << std::endl;
+
+    const double add_ms = Measure([&] { Decimal::Decimal::Add(big, small); }, repeats);
+    const double scalar_add_ms = Measure([&] { ScalarAdd(big_digits, small_digits); }, repeats);
+    std::cout << "Add: " << add_ms << " ms, scalar " << scalar_add_ms << " ms, " << scalar_add_ms / add_ms << "x"
+              << std::endl;
+
+    const double sub_ms = Measure([&] { Decimal::Decimal::Sub(big, small); }, repeats);
+    const double scalar_sub_ms = Measure(
+        [&] {
+            if (!big.Less(small)) {
+                ScalarSub(big_digits, small_digits);
+            }
+        },
+        repeats);
+    std::cout << "Sub: " << sub_ms << " ms, scalar " << scalar_sub_ms << " ms, " << scalar_sub_ms / sub_ms << "x"
+              << std::endl;
+
+    std::cout << "Cmp: " << Measure([&] { big.Less(small); }, repeats) << " ms" << std::endl;
+
+    return 0;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <initializer_list>
 #include <utility>
 #include <string>
@@ -19,8 +20,22 @@ public:
 
     Array(const std::string& str);
 
+    // Maps the file read-only and private; the first write makes the pages writable copies, so the file
+    // itself is never modified.
+    static Array MapFile(const std::string& path);
+
+    static Array MapTemporary(const std::string& dir, size_t size);
+
+    Array& operator=(const Array& other);
+
+    Array& operator=(Array&& other) noexcept;
+
     Array& Copy(const Array& other);
 
+    // Copies of a mapped array, and of any array when built with ARRAY_COPY_ON_WRITE, share one buffer
+    // until a non-const accessor or mutator detaches them. A reference or pointer obtained from a non-const
+    // accessor is therefore only valid until the array is next copied: writing through it afterwards
+    // changes every copy. Re-fetch it after copying.
     unsigned char& GetByIdx(size_t pos);
 
     const unsigned char& GetByIdx(size_t pos) const;
@@ -33,7 +48,9 @@ public:
 
     const unsigned char& Back() const noexcept;
 
-    const unsigned char& Data() const noexcept;
+    unsigned char* Data();
+
+    const unsigned char* Data() const noexcept;
 
     bool IsEmpty() const noexcept;
 
@@ -41,21 +58,47 @@ public:
 
     size_t Capacity() const noexcept;
 
+    bool IsShared() const noexcept;
+
+    bool IsMapped() const noexcept;
+
     void PushBack(unsigned char value);
 
     void PopBack();
 
+    void Append(const unsigned char* data, size_t count);
+
+    void Reverse();
+
     void Clear() noexcept;
 
     ~Array();
 
 private:
+    struct Storage {
+        std::atomic<size_t> refs{1};
+        int fd = -1;
+        bool is_read_only = false;
+        std::string spill_dir;
+    };
+
     size_t sz_;
     size_t cap_;
     unsigned char* arr_;
+    Storage* storage_;
 
     void Resize(size_t size, const unsigned char& value);
 
     void Swap(Array& v) noexcept;
+
+    void Reallocate(size_t new_cap);
+
+    void Detach();
+
+    void Release() noexcept;
+
+    void Map(int fd, size_t size);
+
+    static Storage* MakeStorage(const unsigned char* arr);
 };
 }
\ No newline at end of file
@@ -2,8 +2,13 @@
 
 #include "array.hpp"
 
+#include <cstdint>
+#include <functional>
 #include <initializer_list>
+#include <iostream>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace Decimal{
 class Decimal {
@@ -16,6 +21,9 @@ public:
     Decimal(const Decimal& other);
     Decimal(Decimal&& other);
 
+    Decimal& operator=(const Decimal& other);
+    Decimal& operator=(Decimal&& other) noexcept;
+
     ~Decimal() noexcept = default;
 
     void Copy(const Decimal& other);
@@ -26,15 +34,130 @@ public:
 
     static Decimal Multi(const Decimal& other1, const Decimal& other2);
 
+    static Decimal Pow(const Decimal& base, const Decimal& exp);
+
+    static Decimal ModPow(const Decimal& base, const Decimal& exp, const Decimal& mod);
+
+    static Decimal Sqrt(const Decimal& val);
+
+    static Decimal Gcd(const Decimal& other1, const Decimal& other2);
+
+    static Decimal Product(std::span<const Decimal> values, bool parallel = false);
+
+    static Decimal Factorial(uint64_t n, bool parallel = false);
+
+    static Decimal FromUint64(uint64_t val);
+    static Decimal FromUint128(unsigned __int128 val);
+    static Decimal FromBinary(std::span<const uint8_t> bytes);
+
+    uint64_t             ToUint64() const;
+    unsigned __int128    ToUint128() const;
+    std::vector<uint8_t> ToBinary() const;
+
+    uint64_t PrefixKey() const;
+
+    static std::vector<size_t> SortIndex(std::span<const Decimal> values, bool parallel = false);
+    static void Sort(std::span<Decimal> values, bool parallel = false);
+
+    // The file holds one digit per byte as the raw values 0-9 (not ASCII), least-significant digit first;
+    // any other byte throws NaNException.
+    static Decimal FromFile(const std::string& path);
+
+    static void SetSpillDirectory(const std::string& dir, size_t min_digits);
+
     bool    Less(const Decimal& val) const;
     bool    Greater(const Decimal& val) const;
     bool    Equals(const Decimal& val) const;
 
     std::string String() const;
 
+    static Decimal ReadFrom(std::istream& stream);
+    void           WriteTo(std::ostream& stream) const;
+
 private:
+    using Small = unsigned __int128;
+
+    static constexpr uint32_t LIMB_BASE = 1000000000;
+    static constexpr uint64_t BINARY_BASE = 1ull << 32;
+    static constexpr size_t CONVERT_DIGITS = 19;
+    static constexpr uint64_t CONVERT_POWER = 10000000000000000000ull;
+    static constexpr size_t LIMB_DIGITS = 9;
+    static constexpr size_t SMALL_DIGITS = 38;
+    static constexpr size_t CMP_CHUNK_DIGITS = 4096;
+    static constexpr size_t SPILL_BLOCK_DIGITS = 1 << 16;
+    static constexpr size_t KARATSUBA_LIMBS = 32;
+    static constexpr size_t KERNEL_DIGITS = 32;
+    static constexpr size_t PARALLEL_MIN_FACTORS = 64;
+    static constexpr size_t PARALLEL_MIN_SORT = 1 << 16;
+    static constexpr size_t KEY_DIGITS = 12;
+    static constexpr size_t KEY_PREFIX_BITS = 40;
+    static constexpr uint64_t KEY_MAX_LENGTH = (1ull << 24) - 1;
+    static constexpr size_t RADIX_BITS = 16;
+    static constexpr uint64_t RADIX_MASK = (1ull << RADIX_BITS) - 1;
+    static constexpr size_t MSD_MIN_GROUP = 32;
+    static constexpr size_t IO_CHUNK_DIGITS = 1 << 16;
+    static constexpr size_t RECIPROCAL_SEED_DIGITS = 18;
+    static constexpr size_t SQRT_SEED_DIGITS = 36;
+    static constexpr size_t SQRT_GUARD_DIGITS = 4;
+    static constexpr size_t LEHMER_BITS = 62;
+    static constexpr Small SMALL_LIMIT = static_cast<Small>(10000000000000000000ull) * 10000000000000000000ull;
+
     int8_t      Cmp(const Decimal& val) const;
+    bool        IsZero() const noexcept;
+    size_t      DigitCount() const noexcept;
+    void        Trim();
+    void        Normalize();
+    void        AppendDigits(const unsigned char* digits, size_t count);
+
+    const Array::Array& Digits(Array::Array& scratch) const;
+
+    static Decimal FromSmall(Small val);
+    static Array::Array SmallDigits(Small val);
 
+    static std::vector<uint32_t> ToLimbs(const Array::Array& digits);
+    static std::vector<uint32_t> ToLimbs(const Array::Array& digits, size_t from, size_t count);
+    static Decimal FromLimbs(const std::vector<uint32_t>& limbs);
+    std::vector<uint32_t> BinaryLimbs() const;
+    static Decimal FromBinaryLimbs(std::vector<uint32_t> limbs);
+    template <uint64_t Base>
+    static std::vector<uint32_t> MultiLimbs(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+    template <uint64_t Base>
+    static void AddLimbs(std::vector<uint32_t>& dst, const std::vector<uint32_t>& src, size_t offset);
+    template <uint64_t Base>
+    static void SubLimbs(std::vector<uint32_t>& dst, const std::vector<uint32_t>& src);
+    static std::vector<uint32_t> DecimalToBinary(const Array::Array& digits, size_t from, size_t count,
+                                                 std::vector<std::vector<uint32_t>>& powers);
+    static std::vector<uint32_t> BinaryToDecimal(const std::vector<uint32_t>& limbs, size_t from, size_t count,
+                                                 std::vector<std::vector<uint32_t>>& powers);
+    static void RadixSortKeys(std::vector<std::pair<uint64_t, size_t>>& keyed);
+    static void SortByDigits(std::span<const Decimal> values, std::span<size_t> idx, size_t offset);
+    static void RunChunks(size_t count, size_t threads, const std::function<void(size_t, size_t)>& func);
+    static Decimal MultiBlocked(const Array::Array& digits1, const Array::Array& digits2);
+    static Array::Array NewDigits(size_t size);
+
+    static uint8_t AddDigits(const unsigned char* a, const unsigned char* b, unsigned char* out,
+                             size_t count, uint8_t mem);
+    static uint8_t SubDigits(const unsigned char* a, const unsigned char* b, unsigned char* out,
+                             size_t count, uint8_t mem);
+    static Decimal ProductTree(std::span<const Decimal> values, size_t depth);
+
+    static Decimal ShiftLeft(const Decimal& val, size_t count);
+    static Decimal ShiftRight(const Decimal& val, size_t count);
+    static void    DivMod(const Decimal& val, const Decimal& div, Decimal& quot, Decimal& rem);
+    static Decimal BarrettReduce(const Decimal& val, const Decimal& mod, const Decimal& mu);
+    static Decimal Reciprocal(const Decimal& div, size_t precision);
+    static Small   SqrtSmall(Small val);
+    static Small   GcdSmall(Small val1, Small val2);
+    static std::vector<uint64_t> GcdWords(std::vector<uint64_t> val1, std::vector<uint64_t> val2);
+
+    static inline std::string spill_dir_;
+    static inline size_t spill_min_digits_ = 0;
+
+    Small        small_;
+    bool         is_small_;
     Array::Array digits_;
 };
+
+std::istream& operator>>(std::istream& stream, Decimal& val);
+std::ostream& operator<<(std::ostream& stream, const Decimal& val);
 }
\ No newline at end of file
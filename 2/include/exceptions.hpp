@@ -13,4 +13,19 @@ namespace exception {
     public:
         explicit NegativeException(const std::string& error): std::runtime_error(error) {}
     };
+
+    class DivisionByZeroException: public std::runtime_error {
+    public:
+        explicit DivisionByZeroException(const std::string& error): std::runtime_error(error) {}
+    };
+
+    class OverflowException: public std::runtime_error {
+    public:
+        explicit OverflowException(const std::string& error): std::runtime_error(error) {}
+    };
+
+    class StorageException: public std::runtime_error {
+    public:
+        explicit StorageException(const std::string& error): std::runtime_error(error) {}
+    };
 }
\ No newline at end of file
@@ -1,40 +1,61 @@
 #include <array.hpp>
+#include <exceptions.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <cstring>
 #include <utility>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace Array {
-    Array::Array(): sz_(0), cap_(0), arr_(nullptr) {}
+    Array::Array(): sz_(0), cap_(0), arr_(nullptr), storage_(nullptr) {}
 
     Array::Array(const size_t& size, const unsigned char value)
-        : sz_(size), cap_(size), arr_(size > 0 ? new unsigned char[size] : nullptr) {
+        : sz_(size), cap_(size), arr_(size > 0 ? new unsigned char[size] : nullptr), storage_(MakeStorage(arr_)) {
         if (arr_ != nullptr) {
             memset(arr_, value, size);
         }
     }
 
     Array::Array(const Array& other) 
-        : sz_(other.sz_), cap_(other.cap_), arr_(other.sz_ > 0 ? new unsigned char[other.sz_] : nullptr) {
-        if (arr_ != nullptr) {
+        : sz_(other.sz_), cap_(other.sz_), arr_(nullptr), storage_(nullptr) {
+        if (other.storage_ != nullptr) {
+            other.storage_->refs.fetch_add(1, std::memory_order_relaxed);
+            arr_ = other.arr_;
+            storage_ = other.storage_;
+            cap_ = other.cap_;
+            return;
+        }
+
+        if (sz_ > 0) {
+            arr_ = new unsigned char[sz_];
             memcpy(arr_, other.arr_, sz_);
         }
     }
 
     Array::Array(const std::string& str)
-        : sz_(str.size()), cap_(str.size()), arr_(str.size() > 0 ? new unsigned char[str.size()] : nullptr) {
+        : sz_(str.size()), cap_(str.size()), arr_(str.size() > 0 ? new unsigned char[str.size()] : nullptr),
+          storage_(MakeStorage(arr_)) {
         if (arr_ != nullptr) {
             memcpy(arr_, str.data(), sz_);
         }
     }
 
     Array::Array(Array&& other) noexcept 
-        : sz_(other.sz_), cap_(other.cap_), arr_(other.arr_) {
+        : sz_(other.sz_), cap_(other.cap_), arr_(other.arr_), storage_(other.storage_) {
         other.arr_ = nullptr;
+        other.storage_ = nullptr;
         other.sz_ = 0;
         other.cap_ = 0;
     }
 
     Array::Array(const std::initializer_list<unsigned char>& list)
-        : sz_(list.size()), cap_(list.size()), arr_(list.size() > 0 ? new unsigned char[list.size()] : nullptr) {
+        : sz_(list.size()), cap_(list.size()), arr_(list.size() > 0 ? new unsigned char[list.size()] : nullptr),
+          storage_(MakeStorage(arr_)) {
         if (arr_ != nullptr) {
             size_t i = 0;
             for (const unsigned char& val : list) {
@@ -42,6 +63,18 @@ namespace Array {
             }
         }
     }
+    Array& Array::operator=(const Array& other) {
+        return Copy(other);
+    }
+
+    Array& Array::operator=(Array&& other) noexcept {
+        if (this != &other) {
+            Clear();
+            Swap(other);
+        }
+        return *this;
+    }
+
     Array& Array::Copy(const Array& other) {
         if (this != &other) {
             Array tmp(other);
@@ -52,18 +85,19 @@ namespace Array {
 
     void Array::Swap(Array& other) noexcept {
         std::swap(arr_, other.arr_);
+        std::swap(storage_, other.storage_);
         std::swap(sz_, other.sz_);
         std::swap(cap_, other.cap_);
     }
 
     void Array::Clear() noexcept {
-        delete[] arr_;
-        arr_ = nullptr;
+        Release();
         sz_ = 0;
         cap_ = 0;
     }
 
     unsigned char& Array::GetByIdx(size_t pos) {
+        Detach();
         return arr_[pos];
     }
 
@@ -71,7 +105,17 @@ namespace Array {
         return arr_[pos];
     }
 
+    unsigned char* Array::Data() {
+        Detach();
+        return arr_;
+    }
+
+    const unsigned char* Array::Data() const noexcept {
+        return arr_;
+    }
+
     unsigned char& Array::Front() {
+        Detach();
         return arr_[0];
     }
 
@@ -80,6 +124,7 @@ namespace Array {
     }
 
     unsigned char& Array::Back() {
+        Detach();
         return arr_[sz_ - 1];
     }
 
@@ -89,16 +134,9 @@ namespace Array {
 
     void Array::PushBack(unsigned char value) {
         if (sz_ == cap_) {
-            size_t new_cap = (cap_ == 0) ? 1 : cap_ * 2;
-            unsigned char* new_arr = new unsigned char[new_cap];
-            
-            if (arr_ != nullptr) {
-                memcpy(new_arr, arr_, sz_);
-                delete[] arr_;
-            }
-            
-            arr_ = new_arr;
-            cap_ = new_cap;
+            Reallocate((cap_ == 0) ? 1 : cap_ * 2);
+        } else {
+            Detach();
         }
         
         arr_[sz_++] = value;
@@ -110,6 +148,24 @@ namespace Array {
         }
     }
 
+    void Array::Append(const unsigned char* data, size_t count) {
+        if (sz_ + count > cap_) {
+            Reallocate(std::max(sz_ + count, cap_ * 2));
+        } else {
+            Detach();
+        }
+
+        if (count > 0) {
+            memcpy(arr_ + sz_, data, count);
+            sz_ += count;
+        }
+    }
+
+    void Array::Reverse() {
+        Detach();
+        std::reverse(arr_, arr_ + sz_);
+    }
+
     bool Array::IsEmpty() const noexcept {
         return sz_ == 0;
     }
@@ -122,7 +178,157 @@ namespace Array {
         return cap_;
     }
 
+    bool Array::IsShared() const noexcept {
+        return storage_ != nullptr && storage_->refs.load(std::memory_order_acquire) > 1;
+    }
+
+    bool Array::IsMapped() const noexcept {
+        return storage_ != nullptr && storage_->fd >= 0;
+    }
+
+    Array Array::MapFile(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw exception::StorageException("Cannot open " + path);
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw exception::StorageException("Cannot stat " + path);
+        }
+
+        const size_t size = static_cast<size_t>(st.st_size);
+        Array res;
+        if (size == 0) {
+            close(fd);
+            return res;
+        }
+
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            close(fd);
+            throw exception::StorageException("Cannot map " + path);
+        }
+        madvise(addr, size, MADV_SEQUENTIAL);
+
+        res.arr_ = static_cast<unsigned char*>(addr);
+        res.storage_ = new Storage;
+        res.storage_->fd = fd;
+        res.storage_->is_read_only = true;
+        res.sz_ = size;
+        res.cap_ = size;
+        return res;
+    }
+
+    Array Array::MapTemporary(const std::string& dir, size_t size) {
+        std::string path = dir + "/arrayXXXXXX";
+        int fd = mkstemp(path.data());
+        if (fd < 0) {
+            throw exception::StorageException("Cannot create a file in " + dir);
+        }
+        unlink(path.c_str());
+
+        Array res;
+        res.storage_ = new Storage;
+        res.storage_->spill_dir = dir;
+        res.Map(fd, size);
+        res.sz_ = size;
+        return res;
+    }
+
     Array::~Array() {
-        delete[] arr_;
+        Release();
+    }
+
+    Array::Storage* Array::MakeStorage(const unsigned char* arr) {
+#ifdef ARRAY_COPY_ON_WRITE
+        return arr != nullptr ? new Storage : nullptr;
+#else
+        (void)arr;
+        return nullptr;
+#endif
+    }
+
+    void Array::Map(int fd, size_t size) {
+        const size_t len = size > 0 ? size : 1;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (static_cast<size_t>(st.st_size) < len && ftruncate(fd, len) != 0)) {
+            close(fd);
+            throw exception::StorageException("Cannot resize the backing file");
+        }
+
+        void* addr = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            close(fd);
+            throw exception::StorageException("Cannot map the backing file");
+        }
+        madvise(addr, len, MADV_SEQUENTIAL);
+
+        arr_ = static_cast<unsigned char*>(addr);
+        cap_ = len;
+        storage_->fd = fd;
+    }
+
+    void Array::Reallocate(size_t new_cap) {
+        if (IsMapped() && (storage_->spill_dir.empty() || IsShared())) {
+            Array res = storage_->spill_dir.empty() ? Array(new_cap, 0) : MapTemporary(storage_->spill_dir, new_cap);
+            memcpy(res.arr_, arr_, sz_);
+            res.sz_ = sz_;
+            Swap(res);
+            return;
+        }
+
+        if (IsMapped()) {
+            const int fd = storage_->fd;
+            const size_t sz = sz_;
+            munmap(arr_, cap_);
+            arr_ = nullptr;
+            storage_->fd = -1;
+            sz_ = 0;
+            cap_ = 0;
+            Map(fd, new_cap);
+            sz_ = sz;
+            return;
+        }
+
+        unsigned char* new_arr = new unsigned char[new_cap];
+
+        if (arr_ != nullptr) {
+            memcpy(new_arr, arr_, sz_);
+        }
+
+        Release();
+        arr_ = new_arr;
+        storage_ = MakeStorage(arr_);
+        cap_ = new_cap;
+    }
+
+    void Array::Detach() {
+        if (IsShared()) {
+            Reallocate(cap_);
+        } else if (storage_ != nullptr && storage_->is_read_only) {
+            if (mprotect(arr_, cap_, PROT_READ | PROT_WRITE) != 0) {
+                throw exception::StorageException("Cannot make the mapping writable");
+            }
+            storage_->is_read_only = false;
+        }
+    }
+
+    void Array::Release() noexcept {
+        if (storage_ == nullptr) {
+            delete[] arr_;
+        } else if (storage_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            if (storage_->fd >= 0) {
+                munmap(arr_, cap_);
+                close(storage_->fd);
+            } else {
+                delete[] arr_;
+            }
+            delete storage_;
+        }
+        arr_ = nullptr;
+        storage_ = nullptr;
     }
-}
+}
\ No newline at end of file
@@ -1,14 +1,44 @@
 #include<decimal.hpp>
 #include<exceptions.hpp>
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+namespace {
+    __m128i ExpandMask(uint16_t mask) {
+        const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+
+        __m128i lanes = _mm_cvtsi32_si128(mask);
+        lanes = _mm_unpacklo_epi8(lanes, lanes);
+        lanes = _mm_unpacklo_epi16(lanes, lanes);
+        lanes = _mm_unpacklo_epi32(lanes, lanes);
+
+        return _mm_cmpeq_epi8(_mm_and_si128(lanes, bits), bits);
+    }
+}
+#endif
+
 namespace Decimal {
-    Decimal::Decimal() : digits_() {};
+    Decimal::Decimal() : small_(0), is_small_(true), digits_() {};
 
-    Decimal::Decimal(const size_t& size, const unsigned char ch): digits_(Array::Array(size, ch)) {}
+    Decimal::Decimal(const size_t& size, const unsigned char ch)
+        : small_(0), is_small_(false), digits_(Array::Array(size, ch)) {
+        Normalize();
+    }
 
-    Decimal::Decimal(const std::string& str) : digits_(std::move(Array::Array())) {
+    Decimal::Decimal(const std::string& str) : small_(0), is_small_(false), digits_(std::move(Array::Array())) {
         if (str.empty()) {
-            digits_.PushBack(0);
+            Normalize();
             return;
         }
 
@@ -20,13 +50,11 @@ namespace Decimal {
             digits_.PushBack(ch - '0');
         }
 
-        while (digits_.Size() > 1 && digits_.Back() == 0) {
-            digits_.PopBack();
-        }
+        Normalize();
     }
 
     Decimal::Decimal(const std::initializer_list<unsigned char>& list)
-        : digits_(Array::Array(list.size(), 0)) {
+        : small_(0), is_small_(false), digits_(Array::Array(list.size(), 0)) {
         size_t idx = 0;
         
         for (auto it = list.end(); it != list.begin(); ) {
@@ -34,12 +62,10 @@ namespace Decimal {
             digits_.GetByIdx(idx++) = *it;
         }
 
-        while (digits_.Size() > 1 && digits_.Back() == 0) {
-            digits_.PopBack();
-        }
+        Normalize();
     }
 
-    Decimal::Decimal(const Array::Array& arr): digits_() {
+    Decimal::Decimal(const Array::Array& arr): small_(0), is_small_(false), digits_() {
         for (size_t i = 0; i < arr.Size(); ++i) {
             const unsigned char ch = arr.GetByIdx(i);
             if (ch > 9) {
@@ -47,115 +73,656 @@ namespace Decimal {
             }
             digits_.PushBack(ch);
         }
-        while (digits_.Size() > 1 && digits_.Back() == 0) {
-            digits_.PopBack();
-        }
+
+        Normalize();
     }
 
-    Decimal::Decimal(const Decimal& other): digits_(other.digits_) {}
+    Decimal::Decimal(const Decimal& other)
+        : small_(other.small_), is_small_(other.is_small_), digits_(other.digits_) {}
     
-    Decimal::Decimal(Decimal&& other) :digits_(other.digits_) {}
+    Decimal::Decimal(Decimal&& other)
+        : small_(other.small_), is_small_(other.is_small_), digits_(std::move(other.digits_)) {
+        other.small_ = 0;
+        other.is_small_ = true;
+    }
+
+    Decimal& Decimal::operator=(const Decimal& other) {
+        small_ = other.small_;
+        is_small_ = other.is_small_;
+        digits_ = other.digits_;
+        return *this;
+    }
+
+    Decimal& Decimal::operator=(Decimal&& other) noexcept {
+        small_ = other.small_;
+        is_small_ = other.is_small_;
+        digits_ = std::move(other.digits_);
+        other.small_ = 0;
+        other.is_small_ = true;
+        return *this;
+    }
 
     void Decimal::Copy(const Decimal& other) {
+        small_ = other.small_;
+        is_small_ = other.is_small_;
         digits_.Copy(other.digits_);
     }
 
     Decimal Decimal::Add(const Decimal& val1, const Decimal& val2) {
+        if (val1.is_small_ && val2.is_small_) {
+            return FromSmall(val1.small_ + val2.small_);
+        }
+
+        Array::Array scratch1;
+        Array::Array scratch2;
+        const Array::Array& digits1 = val1.Digits(scratch1);
+        const Array::Array& digits2 = val2.Digits(scratch2);
+
+        const Array::Array& big_num = digits1.Size() >= digits2.Size() ? digits1 : digits2;
+        const Array::Array& small_num = digits1.Size() >= digits2.Size() ? digits2 : digits1;
+
         Decimal res;
-        uint8_t mem = 0;
-        size_t idx = 0;
+        res.digits_ = NewDigits(big_num.Size() + 1);
+        unsigned char* out = res.digits_.Data();
+        const unsigned char* big = big_num.Data();
+
+        uint8_t mem = AddDigits(big, small_num.Data(), out, small_num.Size(), 0);
+        size_t idx = small_num.Size();
+
+        for (; idx < big_num.Size() && mem != 0; ++idx) {
+            const uint8_t sum = big[idx] + mem;
+            mem = sum >= 10;
+            out[idx] = sum - mem * 10;
+        }
+        memcpy(out + idx, big + idx, big_num.Size() - idx);
+        out[big_num.Size()] = mem;
+
+        res.Normalize();
+        return res;
+    }
 
-        for (; idx < std::min(val1.digits_.Size(), val2.digits_.Size()); ++idx) {
-            const unsigned char num1 = val1.digits_.GetByIdx(idx);
-            const unsigned char num2 = val2.digits_.GetByIdx(idx);
+    Decimal Decimal::Sub(const Decimal& val1, const Decimal& val2) {
+        if (val1.is_small_) {
+            if (!val2.is_small_ || val1.small_ < val2.small_) {
+                throw exception::NegativeException("Invalid arguments. Val1 must be great or equal then Val2");
+            }
+            return FromSmall(val1.small_ - val2.small_);
+        }
 
-            uint8_t sum = num1 + num2 + mem;
-            mem = sum / 10;
-            sum = sum % 10;
+        Array::Array scratch;
+        const Array::Array& digits2 = val2.Digits(scratch);
+        const size_t size = val1.digits_.Size();
 
-            res.digits_.PushBack(sum);
+        if (digits2.Size() > size) {
+            throw exception::NegativeException("Invalid arguments. Val1 must be great or equal then Val2");
         }
 
-        const Decimal& big_num = val1.Greater(val2) ? val1 : val2;
+        Decimal res;
+        res.digits_ = NewDigits(size);
+        unsigned char* out = res.digits_.Data();
+        const unsigned char* big = val1.digits_.Data();
+
+        uint8_t mem = SubDigits(big, digits2.Data(), out, digits2.Size(), 0);
+        size_t idx = digits2.Size();
 
-        for (; idx < big_num.digits_.Size(); ++idx) {
-            uint8_t sum = big_num.digits_.GetByIdx(idx) + mem;
-            mem = sum / 10;
-            sum = sum % 10;
-            res.digits_.PushBack(sum);
+        for (; idx < size && mem != 0; ++idx) {
+            mem = big[idx] == 0;
+            out[idx] = big[idx] + mem * 10 - 1;
         }
+        memcpy(out + idx, big + idx, size - idx);
 
-        if (mem > 0) {
-            res.digits_.PushBack(mem);
+        if (mem != 0) {
+            throw exception::NegativeException("Invalid arguments. Val1 must be great or equal then Val2");
         }
 
+        res.Normalize();
         return res;
     }
 
-    Decimal Decimal::Sub(const Decimal& val1, const Decimal& val2) {
-        if(val1.Less(val2)) {
-            throw exception::NegativeException("Invalid arguments. Val1 must be great or equal then Val2");
+    uint8_t Decimal::AddDigits(const unsigned char* a, const unsigned char* b, unsigned char* out,
+                               size_t count, uint8_t mem) {
+        size_t idx = 0;
+
+#ifdef __SSE2__
+        const __m128i nine = _mm_set1_epi8(9);
+        const __m128i ten = _mm_set1_epi8(10);
+
+        for (; idx + KERNEL_DIGITS <= count; idx += KERNEL_DIGITS) {
+            const __m128i sum_lo = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + idx)),
+                                                _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + idx)));
+            const __m128i sum_hi = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + idx + 16)),
+                                                _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + idx + 16)));
+
+            const uint64_t generate = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(sum_lo, nine)))
+                | static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(sum_hi, nine))) << 16;
+            const uint64_t propagate = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(sum_lo, nine)))
+                | static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(sum_hi, nine))) << 16;
+
+            const uint64_t carries = ((generate << 1) | mem) + propagate;
+            const uint64_t carry_in = carries ^ propagate;
+            mem = static_cast<uint8_t>(carries >> KERNEL_DIGITS);
+
+            __m128i res_lo = _mm_sub_epi8(sum_lo, ExpandMask(static_cast<uint16_t>(carry_in)));
+            __m128i res_hi = _mm_sub_epi8(sum_hi, ExpandMask(static_cast<uint16_t>(carry_in >> 16)));
+            res_lo = _mm_min_epu8(res_lo, _mm_sub_epi8(res_lo, ten));
+            res_hi = _mm_min_epu8(res_hi, _mm_sub_epi8(res_hi, ten));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + idx), res_lo);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + idx + 16), res_hi);
+        }
+#endif
+
+        for (; idx < count; ++idx) {
+            const uint8_t sum = a[idx] + b[idx] + mem;
+            mem = sum >= 10;
+            out[idx] = sum - mem * 10;
+        }
+
+        return mem;
+    }
+
+    uint8_t Decimal::SubDigits(const unsigned char* a, const unsigned char* b, unsigned char* out,
+                               size_t count, uint8_t mem) {
+        size_t idx = 0;
+
+#ifdef __SSE2__
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i ten = _mm_set1_epi8(10);
+
+        for (; idx + KERNEL_DIGITS <= count; idx += KERNEL_DIGITS) {
+            const __m128i diff_lo = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + idx)),
+                                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + idx)));
+            const __m128i diff_hi = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + idx + 16)),
+                                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + idx + 16)));
+
+            const uint64_t generate = static_cast<uint32_t>(_mm_movemask_epi8(diff_lo))
+                | static_cast<uint64_t>(_mm_movemask_epi8(diff_hi)) << 16;
+            const uint64_t propagate = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(diff_lo, zero)))
+                | static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(diff_hi, zero))) << 16;
+
+            const uint64_t borrows = ((generate << 1) | mem) + propagate;
+            const uint64_t borrow_in = borrows ^ propagate;
+            mem = static_cast<uint8_t>(borrows >> KERNEL_DIGITS);
+
+            __m128i res_lo = _mm_add_epi8(diff_lo, ExpandMask(static_cast<uint16_t>(borrow_in)));
+            __m128i res_hi = _mm_add_epi8(diff_hi, ExpandMask(static_cast<uint16_t>(borrow_in >> 16)));
+            res_lo = _mm_min_epu8(res_lo, _mm_add_epi8(res_lo, ten));
+            res_hi = _mm_min_epu8(res_hi, _mm_add_epi8(res_hi, ten));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + idx), res_lo);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + idx + 16), res_hi);
         }
+#endif
 
-        if (val1.Equals(val2)) {
+        for (; idx < count; ++idx) {
+            const int8_t diff = a[idx] - b[idx] - mem;
+            mem = diff < 0;
+            out[idx] = diff + mem * 10;
+        }
+
+        return mem;
+    }
+
+    Decimal Decimal::Multi(const Decimal& val1, const Decimal& val2) {
+        if (val1.IsZero() || val2.IsZero()) {
             return Decimal();
         }
 
-        Decimal res = Decimal(val1.digits_.Size(), 0);
-        int mem = 0;
+        if (val1.is_small_ && val2.is_small_) {
+            Small product;
+            if (!__builtin_mul_overflow(val1.small_, val2.small_, &product)) {
+                return FromSmall(product);
+            }
+        }
 
-        for (size_t i = 0; i < val1.digits_.Size(); ++i) {
-            int num1 = val1.digits_.GetByIdx(i);
-            int num2 = (i < val2.digits_.Size()) ? val2.digits_.GetByIdx(i) : 0;
+        Array::Array scratch1;
+        Array::Array scratch2;
+        const Array::Array& digits1 = val1.Digits(scratch1);
+        const Array::Array& digits2 = val2.Digits(scratch2);
 
-            num1 -= mem;
-            if (num1 < num2) {
-                res.digits_.GetByIdx(i) = num1 + 10 - num2;
-                mem = 1;
-            } else {
-                res.digits_.GetByIdx(i) = num1 - num2;
-                mem = 0;
+        if (!spill_dir_.empty() && digits1.Size() + digits2.Size() >= spill_min_digits_) {
+            return MultiBlocked(digits1, digits2);
+        }
+
+        return FromLimbs(MultiLimbs<LIMB_BASE>(ToLimbs(digits1), ToLimbs(digits2)));
+    }
+
+    Decimal Decimal::Product(std::span<const Decimal> values, bool parallel) {
+        size_t depth = 0;
+        if (parallel) {
+            for (size_t threads = std::thread::hardware_concurrency(); threads > 1; threads /= 2) {
+                ++depth;
+            }
+        }
+
+        return ProductTree(values, depth);
+    }
+
+    Decimal Decimal::Factorial(uint64_t n, bool parallel) {
+        std::vector<Decimal> factors;
+        Small chunk = 1;
+
+        for (uint64_t i = 2; i <= n; ++i) {
+            Small next;
+            if (__builtin_mul_overflow(chunk, static_cast<Small>(i), &next) || next >= SMALL_LIMIT) {
+                factors.push_back(FromSmall(chunk));
+                next = i;
+            }
+            chunk = next;
+        }
+        factors.push_back(FromSmall(chunk));
+
+        return Product(factors, parallel);
+    }
+
+    Decimal Decimal::ProductTree(std::span<const Decimal> values, size_t depth) {
+        if (values.empty()) {
+            return Decimal{1};
+        }
+        if (values.size() == 1) {
+            return values[0];
+        }
+
+        const size_t mid = values.size() / 2;
+
+        if (depth > 0 && values.size() >= PARALLEL_MIN_FACTORS) {
+            std::future<Decimal> left = std::async(std::launch::async, ProductTree, values.first(mid), depth - 1);
+            Decimal right = ProductTree(values.subspan(mid), depth - 1);
+            return Multi(left.get(), right);
+        }
+
+        return Multi(ProductTree(values.first(mid), 0), ProductTree(values.subspan(mid), 0));
+    }
+
+    Decimal Decimal::FromUint64(uint64_t val) {
+        return FromSmall(val);
+    }
+
+    Decimal Decimal::FromUint128(unsigned __int128 val) {
+        return FromSmall(val);
+    }
+
+    uint64_t Decimal::ToUint64() const {
+        if (!is_small_ || small_ > UINT64_MAX) {
+            throw exception::OverflowException("Value does not fit in 64 bits");
+        }
+        return static_cast<uint64_t>(small_);
+    }
+
+    unsigned __int128 Decimal::ToUint128() const {
+        if (is_small_) {
+            return small_;
+        }
+
+        Small res = 0;
+        for (size_t i = digits_.Size(); i > 0; --i) {
+            if (__builtin_mul_overflow(res, static_cast<Small>(10), &res) ||
+                __builtin_add_overflow(res, static_cast<Small>(digits_.GetByIdx(i - 1)), &res)) {
+                throw exception::OverflowException("Value does not fit in 128 bits");
             }
         }
-    
-        while (res.digits_.Size() > 1 && res.digits_.Back() == 0) {
-            res.digits_.PopBack();
-        } 
         return res;
     }
 
-    Decimal Decimal::Multi(const Decimal& val1, const Decimal& val2) {
-        if (val1.digits_.Size() == 1 && val1.digits_.GetByIdx(0) == 0) {
-            return Decimal();
+    std::vector<uint8_t> Decimal::ToBinary() const {
+        const std::vector<uint32_t> limbs = BinaryLimbs();
+
+        std::vector<uint8_t> bytes;
+        bytes.reserve(limbs.size() * 4);
+        for (const uint32_t limb : limbs) {
+            for (size_t shift = 0; shift != 32; shift += 8) {
+                bytes.push_back(static_cast<uint8_t>(limb >> shift));
+            }
         }
-        if (val2.digits_.Size() == 1 && val2.digits_.GetByIdx(0) == 0) {
-            return Decimal();
+
+        while (!bytes.empty() && bytes.back() == 0) {
+            bytes.pop_back();
         }
+        return bytes;
+    }
 
-        Decimal res = Decimal(val1.digits_.Size() + val2.digits_.Size(), 0);
+    Decimal Decimal::FromBinary(std::span<const uint8_t> bytes) {
+        size_t size = bytes.size();
+        while (size > 0 && bytes[size - 1] == 0) {
+            --size;
+        }
 
-        for (size_t i = 0; i != val1.digits_.Size(); ++i) {
-            for (size_t j = 0; j != val2.digits_.Size(); ++j) {
-                res.digits_.GetByIdx(i + j) += val1.digits_.GetByIdx(i) * val2.digits_.GetByIdx(j); 
+        if (size <= sizeof(Small)) {
+            Small val = 0;
+            for (size_t i = size; i > 0; --i) {
+                val = (val << 8) | bytes[i - 1];
             }
+            return FromSmall(val);
         }
 
-        uint16_t mem = 0;
+        std::vector<uint32_t> limbs((size + 3) / 4, 0);
+        for (size_t i = 0; i != size; ++i) {
+            limbs[i / 4] |= static_cast<uint32_t>(bytes[i]) << (8 * (i % 4));
+        }
+
+        return FromBinaryLimbs(std::move(limbs));
+    }
+
+    std::vector<uint32_t> Decimal::BinaryLimbs() const {
+        std::vector<uint32_t> limbs;
 
+        if (is_small_) {
+            for (Small val = small_; val != 0; val >>= 32) {
+                limbs.push_back(static_cast<uint32_t>(val));
+            }
+            return limbs;
+        }
+
+        std::vector<std::vector<uint32_t>> powers;
+        limbs = DecimalToBinary(digits_, 0, digits_.Size(), powers);
+        while (!limbs.empty() && limbs.back() == 0) {
+            limbs.pop_back();
+        }
+        return limbs;
+    }
+
+    Decimal Decimal::FromBinaryLimbs(std::vector<uint32_t> limbs) {
+        while (!limbs.empty() && limbs.back() == 0) {
+            limbs.pop_back();
+        }
+
+        if (limbs.size() * 4 <= sizeof(Small)) {
+            Small val = 0;
+            for (size_t i = limbs.size(); i > 0; --i) {
+                val = (val << 32) | limbs[i - 1];
+            }
+            return FromSmall(val);
+        }
+
+        std::vector<std::vector<uint32_t>> powers;
+        return FromLimbs(BinaryToDecimal(limbs, 0, limbs.size(), powers));
+    }
+
+    uint64_t Decimal::PrefixKey() const {
+        const size_t len = DigitCount();
+        uint64_t prefix = 0;
+
+        if (is_small_) {
+            Small val = small_;
+            for (size_t i = KEY_DIGITS; i < len; ++i) {
+                val /= 10;
+            }
+            prefix = static_cast<uint64_t>(val);
+            for (size_t i = len; i < KEY_DIGITS; ++i) {
+                prefix *= 10;
+            }
+        } else {
+            for (size_t i = 0; i != KEY_DIGITS; ++i) {
+                prefix = prefix * 10 + digits_.GetByIdx(len - 1 - i);
+            }
+        }
+
+        return std::min<uint64_t>(len, KEY_MAX_LENGTH) << KEY_PREFIX_BITS | prefix;
+    }
+
+    std::vector<size_t> Decimal::SortIndex(std::span<const Decimal> values, bool parallel) {
+        const size_t n = values.size();
+        const size_t threads = parallel && n >= PARALLEL_MIN_SORT
+            ? std::max<size_t>(std::thread::hardware_concurrency(), 1) : 1;
+
+        std::vector<std::pair<uint64_t, size_t>> keyed(n);
+        RunChunks(n, threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i != end; ++i) {
+                keyed[i] = {values[i].PrefixKey(), i};
+            }
+        });
+        RadixSortKeys(keyed);
+
+        std::vector<size_t> idx(n);
+        for (size_t i = 0; i != n; ++i) {
+            idx[i] = keyed[i].second;
+        }
+
+        auto tie_key = [](uint64_t key) {
+            return (key >> KEY_PREFIX_BITS) == KEY_MAX_LENGTH ? KEY_MAX_LENGTH << KEY_PREFIX_BITS : key;
+        };
+
+        std::vector<std::pair<size_t, size_t>> ties;
+        for (size_t begin = 0; begin < n; ) {
+            size_t end = begin + 1;
+            while (end < n && tie_key(keyed[end].first) == tie_key(keyed[begin].first)) {
+                ++end;
+            }
+            if (end - begin > 1 && (keyed[begin].first >> KEY_PREFIX_BITS) > KEY_DIGITS) {
+                ties.emplace_back(begin, end);
+            }
+            begin = end;
+        }
+
+        RunChunks(ties.size(), threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i != end; ++i) {
+                std::span<size_t> group(idx.data() + ties[i].first, ties[i].second - ties[i].first);
+                const Decimal& first = values[group[0]];
+
+                if (first.is_small_) {
+                    std::sort(group.begin(), group.end(), [&](size_t lhs, size_t rhs) {
+                        return values[lhs].small_ < values[rhs].small_;
+                    });
+                } else if ((keyed[ties[i].first].first >> KEY_PREFIX_BITS) == KEY_MAX_LENGTH) {
+                    std::sort(group.begin(), group.end(), [&](size_t lhs, size_t rhs) {
+                        return values[lhs].Less(values[rhs]);
+                    });
+                } else {
+                    SortByDigits(values, group, KEY_DIGITS);
+                }
+            }
+        });
+
+        return idx;
+    }
+
+    void Decimal::Sort(std::span<Decimal> values, bool parallel) {
+        const std::vector<size_t> idx = SortIndex(values, parallel);
+
+        std::vector<Decimal> sorted;
+        sorted.reserve(values.size());
+        for (const size_t i : idx) {
+            sorted.push_back(std::move(values[i]));
+        }
+        std::move(sorted.begin(), sorted.end(), values.begin());
+    }
+
+    Decimal Decimal::FromFile(const std::string& path) {
+        Decimal res;
+        res.digits_ = Array::Array::MapFile(path);
+
+        const unsigned char* digits = res.digits_.Data();
         for (size_t i = 0; i != res.digits_.Size(); ++i) {
-            uint16_t sum = res.digits_.GetByIdx(i) + mem;
+            if (digits[i] > 9) {
+                throw exception::NaNException("Invalid num");
+            }
+        }
+
+        res.Normalize();
+        return res;
+    }
+
+    void Decimal::SetSpillDirectory(const std::string& dir, size_t min_digits) {
+        spill_dir_ = dir;
+        spill_min_digits_ = min_digits;
+    }
+
+    Decimal Decimal::Pow(const Decimal& base, const Decimal& exp) {
+        if (exp.IsZero()) {
+            return Decimal{1};
+        }
+        if (base.IsZero()) {
+            return Decimal();
+        }
+
+        Array::Array base_scratch;
+        Array::Array exp_scratch;
+        const Array::Array& base_digits = base.Digits(base_scratch);
+        const Array::Array& exp_digits = exp.Digits(exp_scratch);
+
+        size_t zeros = 0;
+        while (zeros < base_digits.Size() && base_digits.GetByIdx(zeros) == 0) {
+            ++zeros;
+        }
+        if (zeros + 1 == base_digits.Size() && base_digits.Back() == 1) {
+            if (zeros == 0) {
+                return Decimal{1};
+            }
+
+            size_t count = 0;
+            for (size_t i = exp_digits.Size(); i > 0; --i) {
+                if (count > (SIZE_MAX - 9) / 10) {
+                    throw std::length_error("Result is too large");
+                }
+                count = count * 10 + exp_digits.GetByIdx(i - 1);
+            }
+            if (count > SIZE_MAX / zeros) {
+                throw std::length_error("Result is too large");
+            }
+            return ShiftLeft(Decimal{1}, count * zeros);
+        }
+
+        Decimal table[10];
+        table[0] = Decimal{1};
+        for (size_t i = 1; i < 10; ++i) {
+            table[i] = Multi(table[i - 1], base);
+        }
+
+        Decimal res = Decimal{1};
+        for (size_t i = exp_digits.Size(); i > 0; --i) {
+            if (i != exp_digits.Size()) {
+                Decimal sq = Multi(res, res);
+                Decimal pow8 = Multi(sq, sq);
+                pow8 = Multi(pow8, pow8);
+                res = Multi(pow8, sq);
+            }
+
+            const unsigned char digit = exp_digits.GetByIdx(i - 1);
+            if (digit != 0) {
+                res = Multi(res, table[digit]);
+            }
+        }
+
+        return res;
+    }
+
+    Decimal Decimal::ModPow(const Decimal& base, const Decimal& exp, const Decimal& mod) {
+        if (mod.IsZero()) {
+            throw exception::DivisionByZeroException("Modulus must be positive");
+        }
+
+        Decimal quot;
+        Decimal reduced;
+        DivMod(base, mod, quot, reduced);
+
+        const size_t k = mod.DigitCount();
+        Decimal mu;
+        Decimal unused;
+        DivMod(ShiftLeft(Decimal{1}, 2 * k), mod, mu, unused);
 
-            res.digits_.GetByIdx(i) = sum % 10;
-            mem = sum / 10;
+        Decimal table[10];
+        DivMod(Decimal{1}, mod, quot, table[0]);
+        for (size_t i = 1; i < 10; ++i) {
+            table[i] = BarrettReduce(Multi(table[i - 1], reduced), mod, mu);
         }
 
-        while (res.digits_.Size() > 1 && res.digits_.Back() == 0) {
-            res.digits_.PopBack();
-        } 
+        Array::Array exp_scratch;
+        const Array::Array& exp_digits = exp.Digits(exp_scratch);
+
+        Decimal res = table[0];
+        for (size_t i = exp_digits.Size(); i > 0; --i) {
+            if (i != exp_digits.Size()) {
+                Decimal sq = BarrettReduce(Multi(res, res), mod, mu);
+                Decimal pow8 = BarrettReduce(Multi(sq, sq), mod, mu);
+                pow8 = BarrettReduce(Multi(pow8, pow8), mod, mu);
+                res = BarrettReduce(Multi(pow8, sq), mod, mu);
+            }
+
+            const unsigned char digit = exp_digits.GetByIdx(i - 1);
+            if (digit != 0) {
+                res = BarrettReduce(Multi(res, table[digit]), mod, mu);
+            }
+        }
 
         return res;
     }
 
+    Decimal Decimal::Sqrt(const Decimal& val) {
+        if (val.is_small_) {
+            return FromSmall(SqrtSmall(val.small_));
+        }
+
+        const size_t len = val.DigitCount();
+        const size_t half = (len - SQRT_SEED_DIGITS + 1) / 2;
+        const Small top = ShiftRight(val, 2 * half).ToUint128();
+        const Small seed = SqrtSmall(top) + 1;
+
+        // inv approximates 10^precision / sqrt(val); the Newton step inv += inv * (1 - val * inv^2) / 2
+        // needs only multiplications, so no reciprocal is recomputed per iteration.
+        const size_t precision = len + SQRT_GUARD_DIGITS;
+        const size_t scale = precision - half;
+        const size_t pow_digits = std::min(scale, SMALL_DIGITS);
+        Small pow = 1;
+        for (size_t i = 0; i != pow_digits; ++i) {
+            pow *= 10;
+        }
+        Decimal inv = ShiftLeft(FromSmall(pow / seed), scale - pow_digits);
+
+        const Decimal one = ShiftLeft(Decimal{1}, 2 * precision);
+        while (true) {
+            const Decimal prod = Multi(val, Multi(inv, inv));
+            const bool is_low = prod.Less(one);
+            const Decimal err = is_low ? Sub(one, prod) : Sub(prod, one);
+            const Decimal step = ShiftRight(Multi(Multi(inv, err), Decimal{5}), 2 * precision + 1);
+            if (step.Less(Decimal{2})) {
+                break;
+            }
+            inv = is_low ? Add(inv, step) : Sub(inv, step);
+        }
+
+        Decimal res = ShiftRight(Multi(val, inv), precision);
+        while (val.Less(Multi(res, res))) {
+            res = Sub(res, Decimal{1});
+        }
+        while (true) {
+            Decimal next = Add(res, Decimal{1});
+            if (val.Less(Multi(next, next))) {
+                return res;
+            }
+            res = std::move(next);
+        }
+    }
+
+    Decimal Decimal::Gcd(const Decimal& other1, const Decimal& other2) {
+        if (other1.IsZero()) {
+            return other2;
+        }
+        if (other2.IsZero()) {
+            return other1;
+        }
+        if (other1.is_small_ && other2.is_small_) {
+            return FromSmall(GcdSmall(other1.small_, other2.small_));
+        }
+
+        const auto to_words = [](const std::vector<uint32_t>& limbs) {
+            std::vector<uint64_t> words((limbs.size() + 1) / 2, 0);
+            for (size_t i = 0; i != limbs.size(); ++i) {
+                words[i / 2] |= static_cast<uint64_t>(limbs[i]) << (32 * (i % 2));
+            }
+            return words;
+        };
+
+        const std::vector<uint64_t> words = GcdWords(to_words(other1.BinaryLimbs()), to_words(other2.BinaryLimbs()));
+
+        std::vector<uint32_t> limbs;
+        limbs.reserve(words.size() * 2);
+        for (const uint64_t word : words) {
+            limbs.push_back(static_cast<uint32_t>(word));
+            limbs.push_back(static_cast<uint32_t>(word >> 32));
+        }
+        return FromBinaryLimbs(std::move(limbs));
+    }
+
     bool Decimal::Less(const Decimal& val) const { 
         return Cmp(val) < 0; 
     }
@@ -169,8 +736,14 @@ namespace Decimal {
     }
 
     std::string Decimal::String() const {
-        if (digits_.IsEmpty()) {
-            return "0";
+        if (is_small_) {
+            std::string res;
+            Small val = small_;
+            do {
+                res += static_cast<char>(val % 10 + '0');
+                val /= 10;
+            } while (val != 0);
+            return std::string(res.rbegin(), res.rend());
         }
 
         std::string res;
@@ -182,7 +755,77 @@ namespace Decimal {
         return res;
     }
 
+    Decimal Decimal::ReadFrom(std::istream& stream) {
+        Decimal res;
+
+        std::istream::sentry sentry(stream);
+        if (!sentry) {
+            return res;
+        }
+
+        std::streambuf* buf = stream.rdbuf();
+        unsigned char chunk[IO_CHUNK_DIGITS];
+        size_t filled = 0;
+        bool has_digits = false;
+
+        for (int ch = buf->sgetc(); ; ch = buf->snextc()) {
+            if (ch == std::char_traits<char>::eof()) {
+                stream.setstate(std::ios::eofbit);
+                break;
+            }
+            if (ch < '0' || ch > '9') {
+                break;
+            }
+
+            has_digits = true;
+            if (ch == '0' && filled == 0 && res.digits_.IsEmpty()) {
+                continue;
+            }
+
+            chunk[filled++] = static_cast<unsigned char>(ch - '0');
+            if (filled == IO_CHUNK_DIGITS) {
+                res.AppendDigits(chunk, filled);
+                filled = 0;
+            }
+        }
+        res.AppendDigits(chunk, filled);
+
+        if (!has_digits) {
+            stream.setstate(std::ios::failbit);
+        }
+
+        res.digits_.Reverse();
+        res.Normalize();
+        return res;
+    }
+
+    void Decimal::WriteTo(std::ostream& stream) const {
+        if (is_small_) {
+            stream << String();
+            return;
+        }
+
+        char chunk[IO_CHUNK_DIGITS];
+        const unsigned char* digits = digits_.Data();
+
+        for (size_t end = digits_.Size(); end > 0; ) {
+            const size_t begin = end > IO_CHUNK_DIGITS ? end - IO_CHUNK_DIGITS : 0;
+            for (size_t i = end; i > begin; --i) {
+                chunk[end - i] = static_cast<char>(digits[i - 1] + '0');
+            }
+            stream.write(chunk, end - begin);
+            end = begin;
+        }
+    }
+
     int8_t Decimal::Cmp(const Decimal& val) const {
+        if (is_small_ && val.is_small_) {
+            return small_ > val.small_ ? 1 : (small_ < val.small_ ? -1 : 0);
+        }
+        if (is_small_ != val.is_small_) {
+            return is_small_ ? -1 : 1;
+        }
+
         if (digits_.Size() > val.digits_.Size()) {
             return 1;
         }
@@ -193,16 +836,687 @@ namespace Decimal {
             return 0;
         }
 
+        const unsigned char* lhs = digits_.Data();
+        const unsigned char* rhs = val.digits_.Data();
+
+        for (size_t end = digits_.Size(); end > 0; ) {
+            const size_t begin = end > CMP_CHUNK_DIGITS ? end - CMP_CHUNK_DIGITS : 0;
+
+            if (memcmp(lhs + begin, rhs + begin, end - begin) != 0) {
+                for (size_t idx = end; idx > begin; --idx) {
+                    if (lhs[idx - 1] != rhs[idx - 1]) {
+                        return lhs[idx - 1] > rhs[idx - 1] ? 1 : -1;
+                    }
+                }
+            }
+            end = begin;
+        }
+
+        return 0;
+    }
+
+    bool Decimal::IsZero() const noexcept {
+        return is_small_ && small_ == 0;
+    }
+
+    size_t Decimal::DigitCount() const noexcept {
+        if (!is_small_) {
+            return digits_.Size();
+        }
+
+        size_t count = 1;
+        for (Small val = small_ / 10; val != 0; val /= 10) {
+            ++count;
+        }
+        return count;
+    }
+
+    void Decimal::Trim() {
+        while (digits_.Size() > 1 && digits_.Back() == 0) {
+            digits_.PopBack();
+        }
+    }
+
+    void Decimal::Normalize() {
+        Trim();
+
+        if (digits_.Size() > SMALL_DIGITS) {
+            is_small_ = false;
+            return;
+        }
+
+        small_ = 0;
         for (size_t i = digits_.Size(); i > 0; --i) {
-            size_t idx = i - 1;
-            if (digits_.GetByIdx(idx) > val.digits_.GetByIdx(idx)) {
-                return 1;
+            small_ = small_ * 10 + digits_.GetByIdx(i - 1);
+        }
+        digits_.Clear();
+        is_small_ = true;
+    }
+
+    void Decimal::AppendDigits(const unsigned char* digits, size_t count) {
+        if (!spill_dir_.empty() && !digits_.IsMapped() && digits_.Size() + count >= spill_min_digits_) {
+            Array::Array mapped = Array::Array::MapTemporary(spill_dir_, digits_.Size());
+            memcpy(mapped.Data(), digits_.Data(), digits_.Size());
+            digits_ = std::move(mapped);
+        }
+        digits_.Append(digits, count);
+    }
+
+    const Array::Array& Decimal::Digits(Array::Array& scratch) const {
+        if (!is_small_) {
+            return digits_;
+        }
+
+        scratch = SmallDigits(small_);
+        return scratch;
+    }
+
+    Decimal Decimal::FromSmall(Small val) {
+        Decimal res;
+        if (val < SMALL_LIMIT) {
+            res.small_ = val;
+        } else {
+            res.digits_ = SmallDigits(val);
+            res.is_small_ = false;
+        }
+        return res;
+    }
+
+    Array::Array Decimal::SmallDigits(Small val) {
+        Array::Array res;
+        do {
+            res.PushBack(static_cast<unsigned char>(val % 10));
+            val /= 10;
+        } while (val != 0);
+        return res;
+    }
+
+    std::vector<uint32_t> Decimal::ToLimbs(const Array::Array& digits) {
+        return ToLimbs(digits, 0, digits.Size());
+    }
+
+    std::vector<uint32_t> Decimal::ToLimbs(const Array::Array& digits, size_t from, size_t count) {
+        std::vector<uint32_t> limbs((count + LIMB_DIGITS - 1) / LIMB_DIGITS, 0);
+
+        for (size_t i = count; i > 0; --i) {
+            uint32_t& limb = limbs[(i - 1) / LIMB_DIGITS];
+            limb = limb * 10 + digits.GetByIdx(from + i - 1);
+        }
+
+        return limbs;
+    }
+
+    template <uint64_t Base>
+    std::vector<uint32_t> Decimal::MultiLimbs(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+        std::vector<uint32_t> res(a.size() + b.size(), 0);
+
+        if (a.size() < KARATSUBA_LIMBS || b.size() < KARATSUBA_LIMBS) {
+            for (size_t i = 0; i != a.size(); ++i) {
+                uint64_t mem = 0;
+                for (size_t j = 0; j != b.size(); ++j) {
+                    uint64_t cur = res[i + j] + static_cast<uint64_t>(a[i]) * b[j] + mem;
+                    res[i + j] = cur % Base;
+                    mem = cur / Base;
+                }
+                res[i + b.size()] = mem;
             }
-            if (digits_.GetByIdx(idx) < val.digits_.GetByIdx(idx)) {
-                return -1;
+            return res;
+        }
+
+        const std::vector<uint32_t>& big = a.size() >= b.size() ? a : b;
+        const std::vector<uint32_t>& small = a.size() >= b.size() ? b : a;
+
+        if (small.size() * 2 <= big.size()) {
+            for (size_t i = 0; i < big.size(); i += small.size()) {
+                const size_t end = std::min(i + small.size(), big.size());
+                const std::vector<uint32_t> part(big.begin() + i, big.begin() + end);
+                AddLimbs<Base>(res, MultiLimbs<Base>(part, small), i);
             }
+            res.resize(a.size() + b.size());
+            return res;
         }
 
-        return 0;
+        const size_t half = big.size() / 2;
+        const std::vector<uint32_t> a0(a.begin(), a.begin() + half);
+        const std::vector<uint32_t> a1(a.begin() + half, a.end());
+        const std::vector<uint32_t> b0(b.begin(), b.begin() + half);
+        const std::vector<uint32_t> b1(b.begin() + half, b.end());
+
+        const std::vector<uint32_t> z0 = MultiLimbs<Base>(a0, b0);
+        const std::vector<uint32_t> z2 = MultiLimbs<Base>(a1, b1);
+
+        std::vector<uint32_t> sum_a = a0;
+        AddLimbs<Base>(sum_a, a1, 0);
+        std::vector<uint32_t> sum_b = b0;
+        AddLimbs<Base>(sum_b, b1, 0);
+
+        std::vector<uint32_t> z1 = MultiLimbs<Base>(sum_a, sum_b);
+        SubLimbs<Base>(z1, z0);
+        SubLimbs<Base>(z1, z2);
+
+        AddLimbs<Base>(res, z0, 0);
+        AddLimbs<Base>(res, z1, half);
+        AddLimbs<Base>(res, z2, 2 * half);
+        res.resize(a.size() + b.size());
+
+        return res;
+    }
+
+    template <uint64_t Base>
+    void Decimal::AddLimbs(std::vector<uint32_t>& dst, const std::vector<uint32_t>& src, size_t offset) {
+        uint64_t mem = 0;
+        size_t pos = offset;
+
+        for (size_t i = 0; i < src.size() || mem != 0; ++i, ++pos) {
+            if (pos == dst.size()) {
+                dst.push_back(0);
+            }
+
+            const uint64_t cur = dst[pos] + mem + (i < src.size() ? src[i] : 0);
+            mem = cur >= Base ? 1 : 0;
+            dst[pos] = cur - mem * Base;
+        }
+    }
+
+    template <uint64_t Base>
+    void Decimal::SubLimbs(std::vector<uint32_t>& dst, const std::vector<uint32_t>& src) {
+        uint64_t mem = 0;
+
+        for (size_t i = 0; i < dst.size() && (i < src.size() || mem != 0); ++i) {
+            const uint64_t sub = mem + (i < src.size() ? src[i] : 0);
+            mem = dst[i] < sub ? 1 : 0;
+            dst[i] = dst[i] + mem * Base - sub;
+        }
+    }
+
+    std::vector<uint32_t> Decimal::DecimalToBinary(const Array::Array& digits, size_t from, size_t count,
+                                                   std::vector<std::vector<uint32_t>>& powers) {
+        if (count <= CONVERT_DIGITS) {
+            uint64_t val = 0;
+            for (size_t i = count; i > 0; --i) {
+                val = val * 10 + digits.GetByIdx(from + i - 1);
+            }
+            return {static_cast<uint32_t>(val), static_cast<uint32_t>(val >> 32)};
+        }
+
+        size_t level = 0;
+        size_t split = CONVERT_DIGITS;
+        while (split * 2 < count) {
+            split *= 2;
+            ++level;
+        }
+
+        while (powers.size() <= level) {
+            if (powers.empty()) {
+                powers.push_back({static_cast<uint32_t>(CONVERT_POWER), static_cast<uint32_t>(CONVERT_POWER >> 32)});
+            } else {
+                powers.push_back(MultiLimbs<BINARY_BASE>(powers.back(), powers.back()));
+                while (powers.back().back() == 0) {
+                    powers.back().pop_back();
+                }
+            }
+        }
+
+        std::vector<uint32_t> res = MultiLimbs<BINARY_BASE>(
+            DecimalToBinary(digits, from + split, count - split, powers), powers[level]);
+        AddLimbs<BINARY_BASE>(res, DecimalToBinary(digits, from, split, powers), 0);
+
+        while (res.size() > 1 && res.back() == 0) {
+            res.pop_back();
+        }
+        return res;
+    }
+
+    std::vector<uint32_t> Decimal::BinaryToDecimal(const std::vector<uint32_t>& limbs, size_t from, size_t count,
+                                                   std::vector<std::vector<uint32_t>>& powers) {
+        if (count <= 2) {
+            uint64_t val = limbs[from];
+            if (count == 2) {
+                val |= static_cast<uint64_t>(limbs[from + 1]) << 32;
+            }
+            return {static_cast<uint32_t>(val % LIMB_BASE), static_cast<uint32_t>(val / LIMB_BASE % LIMB_BASE),
+                    static_cast<uint32_t>(val / LIMB_BASE / LIMB_BASE)};
+        }
+
+        size_t level = 0;
+        size_t split = 2;
+        while (split * 2 < count) {
+            split *= 2;
+            ++level;
+        }
+
+        while (powers.size() <= level) {
+            if (powers.empty()) {
+                const uint64_t power_lo = UINT64_MAX % LIMB_BASE + 1;
+                const uint64_t power_hi = UINT64_MAX / LIMB_BASE;
+                powers.push_back({static_cast<uint32_t>(power_lo), static_cast<uint32_t>(power_hi % LIMB_BASE),
+                                  static_cast<uint32_t>(power_hi / LIMB_BASE)});
+            } else {
+                powers.push_back(MultiLimbs<LIMB_BASE>(powers.back(), powers.back()));
+                while (powers.back().back() == 0) {
+                    powers.back().pop_back();
+                }
+            }
+        }
+
+        std::vector<uint32_t> res = MultiLimbs<LIMB_BASE>(
+            BinaryToDecimal(limbs, from + split, count - split, powers), powers[level]);
+        AddLimbs<LIMB_BASE>(res, BinaryToDecimal(limbs, from, split, powers), 0);
+
+        while (res.size() > 1 && res.back() == 0) {
+            res.pop_back();
+        }
+        return res;
+    }
+
+    void Decimal::RadixSortKeys(std::vector<std::pair<uint64_t, size_t>>& keyed) {
+        std::vector<std::pair<uint64_t, size_t>> buffer(keyed.size());
+
+        for (size_t shift = 0; shift < 64; shift += RADIX_BITS) {
+            std::vector<size_t> counts((1 << RADIX_BITS) + 1, 0);
+            for (const auto& item : keyed) {
+                ++counts[((item.first >> shift) & RADIX_MASK) + 1];
+            }
+            if (std::find(counts.begin(), counts.end(), keyed.size()) != counts.end()) {
+                continue;
+            }
+
+            for (size_t i = 1; i != counts.size(); ++i) {
+                counts[i] += counts[i - 1];
+            }
+            for (const auto& item : keyed) {
+                buffer[counts[(item.first >> shift) & RADIX_MASK]++] = item;
+            }
+            keyed.swap(buffer);
+        }
+    }
+
+    void Decimal::SortByDigits(std::span<const Decimal> values, std::span<size_t> idx, size_t offset) {
+        if (idx.size() < MSD_MIN_GROUP) {
+            std::sort(idx.begin(), idx.end(), [&](size_t lhs, size_t rhs) {
+                return values[lhs].Less(values[rhs]);
+            });
+            return;
+        }
+
+        const size_t len = values[idx[0]].digits_.Size();
+        if (offset == len) {
+            return;
+        }
+
+        size_t counts[11] = {};
+        for (const size_t i : idx) {
+            ++counts[values[i].digits_.GetByIdx(len - 1 - offset) + 1];
+        }
+        for (size_t digit = 1; digit != 11; ++digit) {
+            counts[digit] += counts[digit - 1];
+        }
+
+        std::vector<size_t> buffer(idx.size());
+        size_t starts[11];
+        std::copy(counts, counts + 11, starts);
+        for (const size_t i : idx) {
+            buffer[starts[values[i].digits_.GetByIdx(len - 1 - offset)]++] = i;
+        }
+        std::copy(buffer.begin(), buffer.end(), idx.begin());
+
+        for (size_t digit = 0; digit != 10; ++digit) {
+            if (counts[digit + 1] - counts[digit] > 1) {
+                SortByDigits(values, idx.subspan(counts[digit], counts[digit + 1] - counts[digit]), offset + 1);
+            }
+        }
+    }
+
+    void Decimal::RunChunks(size_t count, size_t threads, const std::function<void(size_t, size_t)>& func) {
+        if (threads <= 1 || count < threads) {
+            func(0, count);
+            return;
+        }
+
+        std::vector<std::future<void>> tasks;
+        const size_t step = (count + threads - 1) / threads;
+        for (size_t begin = step; begin < count; begin += step) {
+            tasks.push_back(std::async(std::launch::async, func, begin, std::min(begin + step, count)));
+        }
+        func(0, std::min(step, count));
+
+        for (auto& task : tasks) {
+            task.get();
+        }
+    }
+
+    Decimal Decimal::MultiBlocked(const Array::Array& digits1, const Array::Array& digits2) {
+        const size_t total = digits1.Size() + digits2.Size();
+
+        Decimal res;
+        res.digits_ = NewDigits(total);
+        unsigned char* out = res.digits_.Data();
+
+        for (size_t i = 0; i < digits1.Size(); i += SPILL_BLOCK_DIGITS) {
+            const std::vector<uint32_t> a = ToLimbs(digits1, i, std::min(SPILL_BLOCK_DIGITS, digits1.Size() - i));
+
+            for (size_t j = 0; j < digits2.Size(); j += SPILL_BLOCK_DIGITS) {
+                const std::vector<uint32_t> b = ToLimbs(digits2, j, std::min(SPILL_BLOCK_DIGITS, digits2.Size() - j));
+                const std::vector<uint32_t> part = MultiLimbs<LIMB_BASE>(a, b);
+
+                size_t pos = i + j;
+                uint8_t mem = 0;
+                for (size_t k = 0; k != part.size() && pos < total; ++k) {
+                    uint32_t limb = part[k];
+                    for (size_t t = 0; t != LIMB_DIGITS && pos < total; ++t, ++pos) {
+                        uint8_t sum = out[pos] + limb % 10 + mem;
+                        out[pos] = sum % 10;
+                        mem = sum / 10;
+                        limb /= 10;
+                    }
+                }
+                for (; mem != 0 && pos < total; ++pos) {
+                    uint8_t sum = out[pos] + mem;
+                    out[pos] = sum % 10;
+                    mem = sum / 10;
+                }
+            }
+        }
+
+        res.Normalize();
+        return res;
+    }
+
+    Array::Array Decimal::NewDigits(size_t size) {
+        if (!spill_dir_.empty() && size >= spill_min_digits_) {
+            return Array::Array::MapTemporary(spill_dir_, size);
+        }
+        return Array::Array(size, 0);
+    }
+
+    Decimal Decimal::FromLimbs(const std::vector<uint32_t>& limbs) {
+        Decimal res;
+        res.digits_ = NewDigits(limbs.size() * LIMB_DIGITS);
+
+        for (size_t i = 0; i != limbs.size(); ++i) {
+            uint32_t limb = limbs[i];
+            for (size_t j = 0; j != LIMB_DIGITS; ++j) {
+                res.digits_.GetByIdx(i * LIMB_DIGITS + j) = limb % 10;
+                limb /= 10;
+            }
+        }
+
+        res.Normalize();
+        return res;
+    }
+
+    Decimal Decimal::ShiftLeft(const Decimal& val, size_t count) {
+        if (val.IsZero()) {
+            return Decimal();
+        }
+
+        Array::Array scratch;
+        const Array::Array& digits = val.Digits(scratch);
+
+        Decimal res;
+        res.digits_ = NewDigits(digits.Size() + count);
+        for (size_t i = 0; i != digits.Size(); ++i) {
+            res.digits_.GetByIdx(i + count) = digits.GetByIdx(i);
+        }
+
+        res.Normalize();
+        return res;
+    }
+
+    Decimal Decimal::ShiftRight(const Decimal& val, size_t count) {
+        Array::Array scratch;
+        const Array::Array& digits = val.Digits(scratch);
+
+        if (count >= digits.Size()) {
+            return Decimal();
+        }
+
+        Decimal res;
+        res.digits_ = NewDigits(digits.Size() - count);
+        for (size_t i = 0; i != res.digits_.Size(); ++i) {
+            res.digits_.GetByIdx(i) = digits.GetByIdx(i + count);
+        }
+
+        res.Normalize();
+        return res;
+    }
+
+    void Decimal::DivMod(const Decimal& val, const Decimal& div, Decimal& quot, Decimal& rem) {
+        if (div.IsZero()) {
+            throw exception::DivisionByZeroException("Division by zero");
+        }
+
+        if (val.is_small_ && div.is_small_) {
+            quot = FromSmall(val.small_ / div.small_);
+            rem = FromSmall(val.small_ % div.small_);
+            return;
+        }
+        if (val.Less(div)) {
+            quot = Decimal();
+            rem = val;
+            return;
+        }
+
+        const size_t precision = val.DigitCount();
+        quot = ShiftRight(Multi(val, Reciprocal(div, precision)), precision);
+        rem = Sub(val, Multi(quot, div));
+
+        while (!rem.Less(div)) {
+            rem = Sub(rem, div);
+            quot = Add(quot, Decimal{1});
+        }
+    }
+
+    Decimal Decimal::BarrettReduce(const Decimal& val, const Decimal& mod, const Decimal& mu) {
+        const size_t k = mod.DigitCount();
+
+        Decimal q = ShiftRight(Multi(ShiftRight(val, k - 1), mu), k + 1);
+        Decimal res = Sub(val, Multi(q, mod));
+
+        while (!res.Less(mod)) {
+            res = Sub(res, mod);
+        }
+
+        return res;
+    }
+
+    Decimal Decimal::Reciprocal(const Decimal& div, size_t precision) {
+        const size_t len = div.DigitCount();
+        const size_t seed_len = std::min(len, RECIPROCAL_SEED_DIGITS);
+        const uint64_t seed = static_cast<uint64_t>(ShiftRight(div, len - seed_len).ToUint128()) + 1;
+
+        const size_t scale = precision - len + seed_len;
+        Small pow = 1;
+        for (size_t i = 0; i != std::min(scale, SMALL_DIGITS); ++i) {
+            pow *= 10;
+        }
+
+        Decimal res = FromSmall(pow / seed);
+        if (scale > SMALL_DIGITS) {
+            res = ShiftLeft(res, scale - SMALL_DIGITS);
+        }
+
+        const Decimal one = ShiftLeft(Decimal{1}, precision);
+        while (true) {
+            const Decimal step = ShiftRight(Multi(res, Sub(one, Multi(div, res))), precision);
+            if (step.IsZero()) {
+                break;
+            }
+            res = Add(res, step);
+        }
+
+        while (!one.Less(Multi(div, Add(res, Decimal{1})))) {
+            res = Add(res, Decimal{1});
+        }
+        return res;
+    }
+
+    Decimal::Small Decimal::SqrtSmall(Small val) {
+        Small res = static_cast<Small>(std::sqrt(static_cast<long double>(val)));
+        while (res * res > val) {
+            --res;
+        }
+        while ((res + 1) * (res + 1) <= val) {
+            ++res;
+        }
+        return res;
+    }
+
+    Decimal::Small Decimal::GcdSmall(Small val1, Small val2) {
+        while (val2 != 0) {
+            const Small rem = val1 % val2;
+            val1 = val2;
+            val2 = rem;
+        }
+        return val1;
+    }
+
+    std::vector<uint64_t> Decimal::GcdWords(std::vector<uint64_t> val1, std::vector<uint64_t> val2) {
+        const auto trim = [](std::vector<uint64_t>& words) {
+            while (!words.empty() && words.back() == 0) {
+                words.pop_back();
+            }
+        };
+
+        const auto less = [](const std::vector<uint64_t>& a, const std::vector<uint64_t>& b) {
+            if (a.size() != b.size()) {
+                return a.size() < b.size();
+            }
+            for (size_t i = a.size(); i > 0; --i) {
+                if (a[i - 1] != b[i - 1]) {
+                    return a[i - 1] < b[i - 1];
+                }
+            }
+            return false;
+        };
+
+        const auto to_small = [](const std::vector<uint64_t>& words) {
+            Small res = 0;
+            for (size_t i = words.size(); i > 0; --i) {
+                res = (res << 64) | words[i - 1];
+            }
+            return res;
+        };
+
+        const auto bit_length = [](const std::vector<uint64_t>& words) {
+            return 64 * (words.size() - 1) + static_cast<size_t>(std::bit_width(words.back()));
+        };
+
+        // The 64 bits of words starting at bit pos, read through a word offset instead of shifting the vector.
+        const auto bits_at = [](const std::vector<uint64_t>& words, size_t pos) {
+            const size_t idx = pos / 64;
+            const size_t bits = pos % 64;
+            uint64_t res = idx < words.size() ? words[idx] >> bits : 0;
+            if (bits != 0 && idx + 1 < words.size()) {
+                res |= words[idx + 1] << (64 - bits);
+            }
+            return res;
+        };
+
+        // a -= q * (b << shift) in place; the caller guarantees the result is non-negative.
+        const auto sub_shifted = [](std::vector<uint64_t>& a, const std::vector<uint64_t>& b, uint64_t q, size_t shift) {
+            const size_t offset = shift / 64;
+            const size_t bits = shift % 64;
+            unsigned __int128 carry = 0;
+            for (size_t i = offset; i != a.size(); ++i) {
+                const size_t j = i - offset;
+                uint64_t word = j < b.size() ? b[j] << bits : 0;
+                if (bits != 0 && j != 0 && j - 1 < b.size()) {
+                    word |= b[j - 1] >> (64 - bits);
+                }
+                carry += static_cast<unsigned __int128>(q) * word;
+                const uint64_t low = static_cast<uint64_t>(carry);
+                carry >>= 64;
+                carry += a[i] < low ? 1 : 0;
+                a[i] -= low;
+                if (carry == 0 && j > b.size()) {
+                    break;
+                }
+            }
+        };
+
+        trim(val1);
+        trim(val2);
+        while (true) {
+            if (less(val1, val2)) {
+                std::swap(val1, val2);
+            }
+            if (val2.empty()) {
+                return val1;
+            }
+            if (val1.size() <= 2) {
+                const Small res = GcdSmall(to_small(val1), to_small(val2));
+                return {static_cast<uint64_t>(res), static_cast<uint64_t>(res >> 64)};
+            }
+            if (val2.size() == 1) {
+                Small rem = 0;
+                for (size_t i = val1.size(); i > 0; --i) {
+                    rem = ((rem << 64) | val1[i - 1]) % val2[0];
+                }
+                const Small res = GcdSmall(val2[0], rem);
+                return {static_cast<uint64_t>(res), static_cast<uint64_t>(res >> 64)};
+            }
+
+            // Lehmer step: run Euclid on the leading bits while both bounds agree on every quotient,
+            // then apply the accumulated cofactors to the full numbers in a single pass.
+            const size_t shift = bit_length(val1) - LEHMER_BITS;
+            int64_t head1 = static_cast<int64_t>(bits_at(val1, shift));
+            int64_t head2 = static_cast<int64_t>(bits_at(val2, shift));
+            int64_t a = 1;
+            int64_t b = 0;
+            int64_t c = 0;
+            int64_t d = 1;
+            while (head2 + c > 0 && head2 + d > 0) {
+                const int64_t q = (head1 + a) / (head2 + c);
+                if (q != (head1 + b) / (head2 + d)) {
+                    break;
+                }
+                a = std::exchange(c, a - q * c);
+                b = std::exchange(d, b - q * d);
+                head1 = std::exchange(head2, head1 - q * head2);
+            }
+
+            if (b == 0) {
+                // The leading bits alone cannot decide a quotient: subtract a shifted estimate of it instead.
+                const size_t len1 = bit_length(val1);
+                const size_t len2 = bit_length(val2);
+                uint64_t q = bits_at(val1, len1 - 63) / (bits_at(val2, len2 - 32) + 1);
+                size_t exp = 0;
+                if (len1 >= len2 + 31) {
+                    exp = len1 - len2 - 31;
+                } else {
+                    q >>= len2 + 31 - len1;
+                }
+                sub_shifted(val1, val2, std::max<uint64_t>(q, 1), exp);
+                trim(val1);
+                continue;
+            }
+
+            val2.resize(val1.size(), 0);
+            __int128 carry1 = 0;
+            __int128 carry2 = 0;
+            for (size_t i = 0; i != val1.size(); ++i) {
+                const __int128 word1 = static_cast<__int128>(val1[i]);
+                const __int128 word2 = static_cast<__int128>(val2[i]);
+                carry1 += a * word1 + b * word2;
+                carry2 += c * word1 + d * word2;
+                val1[i] = static_cast<uint64_t>(carry1);
+                val2[i] = static_cast<uint64_t>(carry2);
+                carry1 >>= 64;
+                carry2 >>= 64;
+            }
+            trim(val1);
+            trim(val2);
+        }
+    }
+
+    std::istream& operator>>(std::istream& stream, Decimal& val) {
+        val = Decimal::ReadFrom(stream);
+        return stream;
+    }
+
+    std::ostream& operator<<(std::ostream& stream, const Decimal& val) {
+        val.WriteTo(stream);
+        return stream;
     }
 }
\ No newline at end of file
@@ -1,4 +1,9 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
 #include "decimal.hpp"
 #include "exceptions.hpp"
 
@@ -189,6 +194,426 @@ TEST_F(DecimalTest, CombinedArithmeticOperations) {
     EXPECT_EQ(result.String(), "500");
 }
 
+TEST_F(DecimalTest, MultiplicationLargeOperands) {
+    Decimal::Decimal n1("99999999999999999999");
+    Decimal::Decimal n2("99999999999999999999");
+    Decimal::Decimal multi = Decimal::Decimal::Multi(n1, n2);
+    EXPECT_EQ(multi.String(), "9999999999999999999800000000000000000001");
+}
+
+TEST_F(DecimalTest, PowOperation) {
+    Decimal::Decimal two("2");
+    EXPECT_EQ(Decimal::Decimal::Pow(two, Decimal::Decimal("0")).String(), "1");
+    EXPECT_EQ(Decimal::Decimal::Pow(two, Decimal::Decimal("10")).String(), "1024");
+    EXPECT_EQ(Decimal::Decimal::Pow(two, Decimal::Decimal("100")).String(),
+              "1267650600228229401496703205376");
+
+    Decimal::Decimal seven("7");
+    EXPECT_EQ(Decimal::Decimal::Pow(seven, Decimal::Decimal("23")).String(), "27368747340080916343");
+
+    Decimal::Decimal thousand("1000");
+    EXPECT_EQ(Decimal::Decimal::Pow(thousand, Decimal::Decimal("4")).String(), "1000000000000");
+
+    Decimal::Decimal zero("0");
+    EXPECT_EQ(Decimal::Decimal::Pow(zero, Decimal::Decimal("5")).String(), "0");
+
+    Decimal::Decimal one("1");
+    EXPECT_EQ(Decimal::Decimal::Pow(one, Decimal::Decimal("1" + std::string(30, '0'))).String(), "1");
+}
+
+TEST_F(DecimalTest, ModPowOperation) {
+    Decimal::Decimal base("4");
+    Decimal::Decimal exp("13");
+    Decimal::Decimal mod("497");
+    EXPECT_EQ(Decimal::Decimal::ModPow(base, exp, mod).String(), "445");
+
+    Decimal::Decimal big_base("123456789012345678901234567890");
+    Decimal::Decimal big_exp("98765432109876543210");
+    Decimal::Decimal big_mod("1000000007");
+    EXPECT_EQ(Decimal::Decimal::ModPow(big_base, big_exp, big_mod).String(),
+              "397050127");
+
+    EXPECT_EQ(Decimal::Decimal::ModPow(base, exp, Decimal::Decimal("1")).String(), "0");
+    EXPECT_THROW(Decimal::Decimal::ModPow(base, exp, Decimal::Decimal("0")), exception::DivisionByZeroException);
+}
+
+TEST_F(DecimalTest, SmallValuePromotion) {
+    Decimal::Decimal max38("99999999999999999999999999999999999999");
+    Decimal::Decimal one("1");
+    Decimal::Decimal sum = Decimal::Decimal::Add(max38, one);
+    EXPECT_EQ(sum.String(), "100000000000000000000000000000000000000");
+    EXPECT_TRUE(sum.Greater(max38));
+    EXPECT_TRUE(Decimal::Decimal::Sub(sum, one).Equals(max38));
+
+    Decimal::Decimal n1("18446744073709551616");
+    Decimal::Decimal multi = Decimal::Decimal::Multi(n1, n1);
+    EXPECT_EQ(multi.String(), "340282366920938463463374607431768211456");
+    EXPECT_EQ(Decimal::Decimal::Multi(multi, n1).String(),
+              "6277101735386680763835789423207666416102355444464034512896");
+
+    EXPECT_TRUE(Decimal::Decimal().Equals(Decimal::Decimal("0")));
+    EXPECT_TRUE(Decimal::Decimal::Sub(sum, sum).Equals(Decimal::Decimal()));
+}
+
+TEST(ArrayTest, CopyIsIndependent) {
+    Array::Array original{1, 2, 3};
+    Array::Array copy(original);
+
+    copy.GetByIdx(0) = 9;
+    copy.PushBack(4);
+
+    EXPECT_EQ(original.Size(), 3);
+    EXPECT_EQ(original.GetByIdx(0), 1);
+    EXPECT_EQ(copy.Size(), 4);
+    EXPECT_EQ(copy.GetByIdx(0), 9);
+    EXPECT_FALSE(original.IsShared());
+    EXPECT_FALSE(copy.IsShared());
+}
+
+#ifdef ARRAY_COPY_ON_WRITE
+TEST(ArrayTest, CopySharesBufferUntilWrite) {
+    Array::Array original{1, 2, 3};
+    Array::Array copy(original);
+    const Array::Array& view = copy;
+
+    EXPECT_TRUE(original.IsShared());
+    EXPECT_EQ(&view.GetByIdx(0), &static_cast<const Array::Array&>(original).GetByIdx(0));
+
+    copy.PopBack();
+    EXPECT_TRUE(copy.IsShared());
+
+    copy.PushBack(7);
+    EXPECT_FALSE(original.IsShared());
+    EXPECT_EQ(original.GetByIdx(2), 3);
+    EXPECT_EQ(copy.GetByIdx(2), 7);
+}
+#endif
+
+TEST(ArrayTest, MappedCopySharesStorage) {
+    const std::string dir = std::filesystem::temp_directory_path().string();
+    Array::Array original = Array::Array::MapTemporary(dir, 4);
+    original.GetByIdx(0) = 1;
+
+    Array::Array copy(original);
+    const Array::Array& view = copy;
+    EXPECT_TRUE(copy.IsMapped());
+    EXPECT_TRUE(original.IsShared());
+    EXPECT_EQ(view.Data(), static_cast<const Array::Array&>(original).Data());
+
+    copy.GetByIdx(0) = 2;
+    EXPECT_TRUE(copy.IsMapped());
+    EXPECT_FALSE(original.IsShared());
+    EXPECT_EQ(original.GetByIdx(0), 1);
+    EXPECT_EQ(copy.GetByIdx(0), 2);
+}
+
+TEST(ArrayTest, MapFileLeavesInputUntouched) {
+    const std::string path = (std::filesystem::temp_directory_path() / "array_map_file").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "abc";
+    }
+    std::filesystem::permissions(path, std::filesystem::perms::owner_read);
+
+    Array::Array mapped = Array::Array::MapFile(path);
+    Array::Array view(mapped);
+    mapped.GetByIdx(0) = 'x';
+    EXPECT_EQ(static_cast<const Array::Array&>(view).GetByIdx(0), 'a');
+
+    Array::Array sole = Array::Array::MapFile(path);
+    sole.GetByIdx(1) = 'y';
+    EXPECT_TRUE(sole.IsMapped());
+    EXPECT_EQ(static_cast<const Array::Array&>(sole).GetByIdx(1), 'y');
+
+    mapped.PushBack('d');
+    EXPECT_EQ(mapped.Size(), 4);
+    EXPECT_EQ(mapped.GetByIdx(0), 'x');
+
+    std::ifstream in(path, std::ios::binary);
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(in), {}), "abc");
+    std::filesystem::remove(path);
+
+    {
+        std::ofstream out(path, std::ios::binary);
+    }
+    EXPECT_TRUE(Array::Array::MapFile(path).IsEmpty());
+    EXPECT_EQ(std::filesystem::file_size(path), 0);
+    std::filesystem::remove(path);
+}
+
+TEST_F(DecimalTest, SpilledArithmetic) {
+    const std::string dir = std::filesystem::temp_directory_path().string();
+
+    std::string digits1;
+    std::string digits2;
+    for (size_t i = 0; i < 70000; ++i) {
+        digits1 += static_cast<char>('1' + i % 9);
+        digits2 += static_cast<char>('9' - i % 7);
+    }
+    Decimal::Decimal n1(digits1);
+    Decimal::Decimal n2(digits2);
+
+    Decimal::Decimal sum = Decimal::Decimal::Add(n1, n2);
+    Decimal::Decimal diff = Decimal::Decimal::Sub(n2, n1);
+    Decimal::Decimal multi = Decimal::Decimal::Multi(n1, n2);
+
+    Decimal::Decimal::SetSpillDirectory(dir, 1000);
+    EXPECT_TRUE(Decimal::Decimal::Add(n1, n2).Equals(sum));
+    EXPECT_TRUE(Decimal::Decimal::Sub(n2, n1).Equals(diff));
+    EXPECT_TRUE(Decimal::Decimal::Multi(n1, n2).Equals(multi));
+    EXPECT_TRUE(n1.Less(n2));
+    Decimal::Decimal::SetSpillDirectory("", 0);
+}
+
+TEST_F(DecimalTest, FromFile) {
+    const std::string path = (std::filesystem::temp_directory_path() / "decimal_from_file").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        const char digits[] = {5, 4, 3, 2, 1, 0, 0};
+        out.write(digits, sizeof(digits));
+    }
+    EXPECT_EQ(Decimal::Decimal::FromFile(path).String(), "12345");
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "12";
+    }
+    EXPECT_THROW(Decimal::Decimal::FromFile(path), exception::NaNException);
+
+    for (char bad : {char(10), char(0xFF)}) {
+        {
+            std::ofstream out(path, std::ios::binary);
+            const char digits[] = {5, 4, bad, 1};
+            out.write(digits, sizeof(digits));
+        }
+        EXPECT_THROW(Decimal::Decimal::FromFile(path), exception::NaNException);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_F(DecimalTest, MultiplicationKaratsuba) {
+    Decimal::Decimal n1(std::string(1000, '9'));
+    Decimal::Decimal square = Decimal::Decimal::Multi(n1, n1);
+    EXPECT_EQ(square.String(), std::string(999, '9') + "8" + std::string(999, '0') + "1");
+
+    Decimal::Decimal n2(std::string(3000, '9'));
+    Decimal::Decimal n3(std::string(400, '9'));
+    Decimal::Decimal multi = Decimal::Decimal::Multi(n2, n3);
+    EXPECT_EQ(multi.String(), std::string(399, '9') + "8" + std::string(2600, '9') + std::string(399, '0') + "1");
+}
+
+TEST_F(DecimalTest, ProductAndFactorial) {
+    std::vector<Decimal::Decimal> values;
+    Decimal::Decimal folded("1");
+    for (size_t i = 1; i <= 200; ++i) {
+        values.emplace_back(std::to_string(i * 7919));
+        folded = Decimal::Decimal::Multi(folded, values.back());
+    }
+    EXPECT_TRUE(Decimal::Decimal::Product(values).Equals(folded));
+    EXPECT_TRUE(Decimal::Decimal::Product(values, true).Equals(folded));
+    EXPECT_EQ(Decimal::Decimal::Product({}).String(), "1");
+
+    EXPECT_EQ(Decimal::Decimal::Factorial(0).String(), "1");
+    EXPECT_EQ(Decimal::Decimal::Factorial(25).String(), "15511210043330985984000000");
+
+    std::string fact = Decimal::Decimal::Factorial(1000, true).String();
+    EXPECT_EQ(fact.size(), 2568);
+    EXPECT_EQ(fact.substr(0, 30), "402387260077093773543702433923");
+    EXPECT_EQ(fact.substr(fact.size() - 249), std::string(249, '0'));
+}
+
+TEST_F(DecimalTest, LongCarryChains) {
+    Decimal::Decimal one("1");
+    Decimal::Decimal nines(std::string(100, '9'));
+    Decimal::Decimal power("1" + std::string(100, '0'));
+
+    EXPECT_TRUE(Decimal::Decimal::Add(nines, one).Equals(power));
+    EXPECT_TRUE(Decimal::Decimal::Sub(power, one).Equals(nines));
+    EXPECT_THROW(Decimal::Decimal::Sub(nines, power), exception::NegativeException);
+
+    std::string digits1;
+    std::string digits2;
+    for (size_t i = 0; i < 1000; ++i) {
+        digits1 += static_cast<char>('0' + (i * 7 + i / 13) % 10);
+        digits2 += static_cast<char>('0' + (i * 3 + i / 5) % 10);
+    }
+    Decimal::Decimal n1(digits1);
+    Decimal::Decimal n2(digits2);
+    Decimal::Decimal sum = Decimal::Decimal::Add(n1, n2);
+    EXPECT_TRUE(Decimal::Decimal::Sub(sum, n2).Equals(n1));
+    EXPECT_TRUE(Decimal::Decimal::Sub(sum, n1).Equals(n2));
+}
+
+TEST_F(DecimalTest, BinaryConversion) {
+    std::vector<uint8_t> bytes = Decimal::Decimal("18446744073709551616").ToBinary();
+    EXPECT_EQ(bytes, std::vector<uint8_t>({0, 0, 0, 0, 0, 0, 0, 0, 1}));
+    EXPECT_TRUE(Decimal::Decimal("0").ToBinary().empty());
+
+    std::vector<uint8_t> ones(200, 0xFF);
+    Decimal::Decimal expected = Decimal::Decimal::Sub(
+        Decimal::Decimal::Pow(Decimal::Decimal("2"), Decimal::Decimal("1600")), Decimal::Decimal("1"));
+    EXPECT_TRUE(Decimal::Decimal::FromBinary(ones).Equals(expected));
+    EXPECT_EQ(expected.ToBinary(), ones);
+
+    std::vector<uint8_t> pattern;
+    for (size_t i = 0; i < 5000; ++i) {
+        pattern.push_back(static_cast<uint8_t>(i * 31 + i / 7));
+    }
+    pattern.back() = 1;
+    EXPECT_EQ(Decimal::Decimal::FromBinary(pattern).ToBinary(), pattern);
+
+    Decimal::Decimal fact = Decimal::Decimal::Factorial(500);
+    EXPECT_TRUE(Decimal::Decimal::FromBinary(fact.ToBinary()).Equals(fact));
+}
+
+TEST_F(DecimalTest, IntegerConversion) {
+    EXPECT_EQ(Decimal::Decimal::FromUint64(UINT64_MAX).String(), "18446744073709551615");
+    EXPECT_EQ(Decimal::Decimal("18446744073709551615").ToUint64(), UINT64_MAX);
+    EXPECT_THROW(Decimal::Decimal("18446744073709551616").ToUint64(), exception::OverflowException);
+
+    const unsigned __int128 max128 = ~static_cast<unsigned __int128>(0);
+    Decimal::Decimal big = Decimal::Decimal::FromUint128(max128);
+    EXPECT_EQ(big.String(), "340282366920938463463374607431768211455");
+    EXPECT_TRUE(big.ToUint128() == max128);
+    EXPECT_THROW(Decimal::Decimal::Add(big, Decimal::Decimal("1")).ToUint128(), exception::OverflowException);
+}
+
+TEST_F(DecimalTest, PrefixKeyOrder) {
+    Decimal::Decimal n1("123456789012");
+    Decimal::Decimal n2("123456789013");
+    Decimal::Decimal n3("99");
+    Decimal::Decimal n4(std::string(50, '1'));
+
+    EXPECT_LT(n1.PrefixKey(), n2.PrefixKey());
+    EXPECT_LT(n3.PrefixKey(), n1.PrefixKey());
+    EXPECT_LT(n2.PrefixKey(), n4.PrefixKey());
+    EXPECT_EQ(Decimal::Decimal("0").PrefixKey(), Decimal::Decimal().PrefixKey());
+}
+
+TEST_F(DecimalTest, SortLargeCollection) {
+    std::vector<Decimal::Decimal> values;
+    for (size_t i = 0; i < 3000; ++i) {
+        const size_t len = 1 + (i * 7919) % 60;
+        std::string digits = "1234567890123" + std::to_string(i * 2654435761u % 1000003);
+        digits = digits.substr(0, std::min(len, digits.size())) + std::string(len > digits.size() ? len - digits.size() : 0, '7');
+        digits.back() = static_cast<char>('0' + i % 10);
+        values.emplace_back(digits);
+    }
+    values.emplace_back("0");
+    values.emplace_back("0");
+
+    std::vector<Decimal::Decimal> expected = values;
+    std::sort(expected.begin(), expected.end(), [](const Decimal::Decimal& a, const Decimal::Decimal& b) {
+        return a.Less(b);
+    });
+
+    std::vector<Decimal::Decimal> sorted = values;
+    Decimal::Decimal::Sort(sorted);
+    std::vector<Decimal::Decimal> sorted_parallel = values;
+    Decimal::Decimal::Sort(sorted_parallel, true);
+
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_TRUE(sorted[i].Equals(expected[i]));
+        EXPECT_TRUE(sorted_parallel[i].Equals(expected[i]));
+    }
+
+    std::vector<size_t> idx = Decimal::Decimal::SortIndex(values);
+    for (size_t i = 1; i < idx.size(); ++i) {
+        EXPECT_FALSE(values[idx[i]].Less(values[idx[i - 1]]));
+    }
+}
+
+TEST_F(DecimalTest, SortSaturatedLengths) {
+    const size_t long_length = size_t(1) << 24;
+    std::vector<Decimal::Decimal> values;
+    values.emplace_back("9" + std::string(long_length, '0'));
+    values.emplace_back("1" + std::string(long_length + 1, '0'));
+    values.emplace_back("5");
+
+    Decimal::Decimal::Sort(values);
+    EXPECT_EQ(values[0].String(), "5");
+    EXPECT_EQ(values[1].String(), "9" + std::string(long_length, '0'));
+    EXPECT_EQ(values[2].String(), "1" + std::string(long_length + 1, '0'));
+}
+
+TEST_F(DecimalTest, StreamInput) {
+    std::istringstream input("  000123 456789012345678901234567890123456789012345 abc");
+    Decimal::Decimal n1;
+    Decimal::Decimal n2;
+    Decimal::Decimal n3("5");
+
+    input >> n1 >> n2;
+    EXPECT_EQ(n1.String(), "123");
+    EXPECT_EQ(n2.String(), "456789012345678901234567890123456789012345");
+    EXPECT_TRUE(input.good());
+
+    input >> n3;
+    EXPECT_TRUE(input.fail());
+    EXPECT_EQ(n3.String(), "0");
+
+    std::istringstream zeros("0000");
+    zeros >> n1;
+    EXPECT_FALSE(zeros.fail());
+    EXPECT_EQ(n1.String(), "0");
+}
+
+TEST_F(DecimalTest, StreamRoundTrip) {
+    std::string digits;
+    for (size_t i = 0; i < 200000; ++i) {
+        digits += static_cast<char>('1' + i % 9);
+    }
+
+    std::istringstream input(digits);
+    Decimal::Decimal big = Decimal::Decimal::ReadFrom(input);
+    EXPECT_TRUE(input.eof());
+    EXPECT_TRUE(big.Equals(Decimal::Decimal(digits)));
+
+    std::ostringstream output;
+    output << big << " " << Decimal::Decimal("42");
+    EXPECT_EQ(output.str(), digits + " 42");
+}
+
+TEST_F(DecimalTest, SqrtOperation) {
+    EXPECT_EQ(Decimal::Decimal::Sqrt(Decimal::Decimal("0")).String(), "0");
+    EXPECT_EQ(Decimal::Decimal::Sqrt(Decimal::Decimal("15")).String(), "3");
+    EXPECT_EQ(Decimal::Decimal::Sqrt(Decimal::Decimal("16")).String(), "4");
+    EXPECT_EQ(Decimal::Decimal::Sqrt(Decimal::Decimal(std::string(100, '9'))).String(), std::string(50, '9'));
+
+    Decimal::Decimal root = Decimal::Decimal::Factorial(400);
+    Decimal::Decimal square = Decimal::Decimal::Multi(root, root);
+    EXPECT_TRUE(Decimal::Decimal::Sqrt(square).Equals(root));
+    EXPECT_TRUE(Decimal::Decimal::Sqrt(Decimal::Decimal::Sub(square, Decimal::Decimal("1")))
+                    .Equals(Decimal::Decimal::Sub(root, Decimal::Decimal("1"))));
+
+    Decimal::Decimal big = Decimal::Decimal::Multi(square, Decimal::Decimal("7"));
+    Decimal::Decimal big_root = Decimal::Decimal::Sqrt(big);
+    Decimal::Decimal next = Decimal::Decimal::Add(big_root, Decimal::Decimal("1"));
+    EXPECT_FALSE(big.Less(Decimal::Decimal::Multi(big_root, big_root)));
+    EXPECT_TRUE(big.Less(Decimal::Decimal::Multi(next, next)));
+}
+
+TEST_F(DecimalTest, GcdOperation) {
+    EXPECT_EQ(Decimal::Decimal::Gcd(Decimal::Decimal("12"), Decimal::Decimal("18")).String(), "6");
+    EXPECT_EQ(Decimal::Decimal::Gcd(Decimal::Decimal("0"), Decimal::Decimal("5")).String(), "5");
+
+    Decimal::Decimal f300 = Decimal::Decimal::Factorial(300);
+    Decimal::Decimal f200 = Decimal::Decimal::Factorial(200);
+    EXPECT_TRUE(Decimal::Decimal::Gcd(f300, f200).Equals(f200));
+    EXPECT_EQ(Decimal::Decimal::Gcd(f300, Decimal::Decimal::Add(f300, Decimal::Decimal("1"))).String(), "1");
+
+    Decimal::Decimal odd = Decimal::Decimal::Pow(Decimal::Decimal("3"), Decimal::Decimal("90"));
+    EXPECT_TRUE(Decimal::Decimal::Gcd(Decimal::Decimal::Multi(odd, Decimal::Decimal("1024")), f200)
+                    .Equals(Decimal::Decimal::Multi(odd, Decimal::Decimal("1024"))));
+
+    std::vector<Decimal::Decimal> fib{Decimal::Decimal("0"), Decimal::Decimal("1")};
+    for (size_t i = 2; i <= 1200; ++i) {
+        fib.push_back(Decimal::Decimal::Add(fib[i - 1], fib[i - 2]));
+    }
+    EXPECT_EQ(Decimal::Decimal::Gcd(fib[1200], fib[1199]).String(), "1");
+    EXPECT_TRUE(Decimal::Decimal::Gcd(fib[1200], fib[900]).Equals(fib[300]));
+    EXPECT_TRUE(Decimal::Decimal::Gcd(Decimal::Decimal::Multi(fib[1199], fib[600]), fib[1200]).Equals(fib[600]));
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+#include "collision.hpp"
+#include "kernels.hpp"
+#include "parser.hpp"
+#include "pentagon.hpp"
+#include "rhombus.hpp"
+#include "store.hpp"
+#include "trapezoid.hpp"
+#include "variant_vector.hpp"
+#include "vector.hpp"
+
+namespace {
+vector::Shape RandomShape(size_t idx, std::mt19937& gen) {
+    std::uniform_real_distribution<double> offset(-1000.0, 1000.0);
+    const double dx = offset(gen), dy = offset(gen);
+
+    switch (idx % 3) {
+    case 0:
+        return figure::Pentagon(figure::Point(dx + 1.0, dy), figure::Point(dx + 0.309, dy + 0.951),
+                                figure::Point(dx - 0.809, dy + 0.588), figure::Point(dx - 0.809, dy - 0.588),
+                                figure::Point(dx + 0.309, dy - 0.951));
+    case 1:
+        return figure::Rhombus(figure::Point(dx, dy), figure::Point(dx + 2, dy + 1), figure::Point(dx, dy + 2),
+                               figure::Point(dx - 2, dy + 1));
+    default:
+        return figure::Trapezoid(figure::Point(dx, dy), figure::Point(dx + 4, dy), figure::Point(dx + 3, dy + 3),
+                                 figure::Point(dx + 1, dy + 3));
+    }
+}
+
+std::unique_ptr<figure::Figure> HeapCopy(const vector::Shape& shape) {
+    return std::visit(
+        [](const auto& fig) -> std::unique_ptr<figure::Figure> {
+            return std::make_unique<std::decay_t<decltype(fig)>>(fig);
+        },
+        shape);
+}
+
+template <typename Func>
+double Measure(Func func, int repeats) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        func();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / repeats;
+}
+}
+
+int main(int argc, char** argv) {
+    const size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const int repeats = 5;
+
+    std::mt19937 gen(42);
+    std::vector<std::unique_ptr<figure::Figure>> figures;
+    figures.reserve(count);
+
+    vector::Vector vec;
+    vector::VariantVector variants;
+    vec.Reserve(count);
+    vec.EnableSummary();
+    variants.Reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        variants.PushBack(RandomShape(i, gen));
+        figures.push_back(HeapCopy(variants.Back()));
+        vec.PushBack(figures.back().get());
+    }
+    store::Store soa(vec);
+
+    double vec_total = 0, par_total = 0, var_total = 0, soa_total = 0;
+    std::cout << "Figures: " << count << ", " << repeats << " runs each, kernels: " << kernels::ActiveIsa()
+              << std::endl;
+    const double virtual_ms = Measure([&] { vec_total = vec.TotalArea(); }, repeats);
+    std::cout << "Vector::TotalArea: " << virtual_ms << " ms" << std::endl;
+    std::cout << "Vector::TotalArea(threads): " << Measure([&] { par_total = vec.TotalArea(0); }, repeats) << " ms"
+              << std::endl;
+    const double variant_ms = Measure([&] { var_total = variants.TotalArea(); }, repeats);
+    std::cout << "VariantVector::TotalArea: " << variant_ms << " ms" << std::endl;
+    std::cout << "VariantVector vs virtual dispatch (TotalArea): " << virtual_ms / variant_ms << "x" << std::endl;
+
+    const double virtual_areas_ms = Measure([&] { vec.Areas(); }, repeats);
+    const double variant_areas_ms = Measure([&] { variants.Areas(); }, repeats);
+    std::cout << "Vector::Areas: " << virtual_areas_ms << " ms" << std::endl;
+    std::cout << "VariantVector::Areas: " << variant_areas_ms << " ms" << std::endl;
+    std::cout << "VariantVector vs virtual dispatch (Areas): " << virtual_areas_ms / variant_areas_ms << "x"
+              << std::endl;
+    std::cout << "Store::TotalArea: " << Measure([&] { soa_total = soa.TotalArea(); }, repeats) << " ms" << std::endl;
+    std::cout << "Vector::Summarize: " << Measure([&] { vec.Summarize(); }, repeats) << " ms" << std::endl;
+    std::cout << "Totals: " << vec_total << " / " << par_total << " / " << var_total << " / " << soa_total << std::endl;
+
+    std::cout << "Store::TopK(100): " << Measure([&] { soa.TopK(100); }, repeats) << " ms" << std::endl;
+    std::cout << "Store::SortByArea(threads): " << Measure([&] { soa.SortByArea(0); }, 1) << " ms" << std::endl;
+    std::cout << "Store::AreaPercentile(95): " << soa.AreaPercentile(95) << std::endl;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "figures_benchmark.bin").string();
+    double mapped_total = 0;
+    std::cout << "Store::WriteBinary: " << Measure([&] { soa.WriteBinary(path); }, 1) << " ms" << std::endl;
+    std::cout << "Store::MapBinary + TotalArea: "
+              << Measure([&] { mapped_total = store::Store::MapBinary(path).TotalArea(); }, repeats) << " ms"
+              << std::endl;
+    std::cout << "Mapped total: " << mapped_total << std::endl;
+    std::filesystem::remove(path);
+
+    const size_t erase_count = std::min<size_t>(count, 1000000);
+    double erase_ms = 0;
+    size_t erased = 0;
+    for (int i = 0; i < repeats; ++i) {
+        vector::Vector subset;
+        subset.InsertRange(0, vec.Data(), erase_count);
+        auto every_other = [n = size_t(0)](const figure::Figure&) mutable { return n++ % 2 != 0; };
+        erase_ms += Measure([&] { erased = subset.EraseIf(every_other); }, 1) / repeats;
+    }
+    std::cout << "Vector::EraseIf(" << erased << " of " << erase_count << "): " << erase_ms << " ms" << std::endl;
+
+    const size_t loop_count = std::min<size_t>(count, 100000);
+    vector::Vector subset;
+    subset.InsertRange(0, vec.Data(), loop_count);
+    const double loop_ms = Measure(
+        [&] {
+            for (size_t i = subset.Size(); i-- > 0;) {
+                if (i % 2) {
+                    subset.Erase(i);
+                }
+            }
+        },
+        1);
+    std::cout << "Vector::Erase loop(" << loop_count - subset.Size() << " of " << loop_count << "): " << loop_ms
+              << " ms" << std::endl;
+
+    std::vector<const figure::Figure*> scene;
+    for (size_t i = 0; i < std::min<size_t>(count, 1000000); ++i) {
+        scene.push_back(&vec[i]);
+    }
+    for (size_t threads : {1, 0}) {
+        size_t pairs = 0;
+        const double ms = Measure([&] { pairs = spatial::OverlappingPairs(scene, threads).size(); }, 1);
+        std::cout << "spatial::OverlappingPairs(" << scene.size() << " figures, " << threads << " threads): " << ms
+                  << " ms, " << pairs << " pairs" << std::endl;
+    }
+
+    const size_t brute_count = std::min<size_t>(scene.size(), 2000);
+    size_t brute_pairs = 0;
+    const double brute_ms = Measure(
+        [&] {
+            for (size_t i = 0; i < brute_count; ++i) {
+                for (size_t j = i + 1; j < brute_count; ++j) {
+                    brute_pairs += spatial::Overlaps(*scene[i], *scene[j]);
+                }
+            }
+        },
+        1);
+    std::cout << "Brute-force pairs(" << brute_count << " figures): " << brute_ms << " ms, " << brute_pairs
+              << " pairs" << std::endl;
+
+    std::uniform_real_distribution<double> coord(-2.0, 2.0);
+    std::vector<figure::Point> samples(std::min<size_t>(count, 10000000));
+    for (auto& point : samples) {
+        point = figure::Point(coord(gen), coord(gen));
+    }
+
+    const figure::Pentagon pent;
+    size_t scalar_hits = 0, batched_hits = 0;
+    const double scalar_ms = Measure(
+        [&] {
+            scalar_hits = 0;
+            for (const auto& point : samples) {
+                scalar_hits += figure::Contains(pent, point);
+            }
+        },
+        1);
+    const double batched_ms = Measure(
+        [&] {
+            batched_hits = 0;
+            for (uint64_t mask : pent.Contains(samples)) {
+                batched_hits += __builtin_popcountll(mask);
+            }
+        },
+        repeats);
+    std::cout << "figure::Contains per point(" << samples.size() << "): " << scalar_ms << " ms, " << scalar_hits
+              << " hits" << std::endl;
+    std::cout << "Pentagon::Contains batched(" << samples.size() << "): " << batched_ms << " ms, " << batched_hits
+              << " hits" << std::endl;
+
+    const char* kinds[] = {"pentagon", "rhombus", "trapezoid"};
+    std::ostringstream text;
+    text.precision(17);
+    for (size_t i = 0; i < std::min<size_t>(count, 1000000); ++i) {
+        text << kinds[variants[i].index()] << ' ';
+        std::visit([&](const auto& fig) { text << fig << '\n'; }, variants[i]);
+    }
+
+    const std::string input = text.str();
+    for (size_t threads : {1, 0}) {
+        const double ms = Measure([&] { parser::Parse(input, threads); }, repeats);
+        std::cout << "parser::Parse(" << threads << " threads): " << ms << " ms, "
+                  << input.size() / ms / 1000.0 << " MB/s" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace arena {
+
+// Types whose destructor does nothing beyond being virtual may specialize this to false, so that Make
+// does not register a finalizer for them and MakeRecyclable accepts them.
+template <typename T>
+inline constexpr bool NEEDS_FINALIZER = !std::is_trivially_destructible_v<T>;
+
+class Arena {
+    struct Block {
+        Block* next;
+        size_t size;
+    };
+
+    struct Finalizer {
+        Finalizer* next;
+        void (*destroy)(void*);
+        void* object;
+    };
+
+    // Precedes every MakeRecyclable object; next links the slot into a free list once it is recycled.
+    struct alignas(std::max_align_t) Slot {
+        size_t size;
+        Slot* next;
+    };
+
+    struct FreeList {
+        size_t size;
+        Slot* head;
+    };
+
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    Block* blocks_;
+    char* cur_;
+    char* end_;
+    Finalizer* finalizers_;
+    size_t block_count_;
+    std::vector<Block*> sorted_blocks_;
+    std::vector<FreeList> free_lists_;
+
+    void* Allocate(size_t size, size_t align);
+    void* AllocateSlot(size_t size);
+    void NewBlock(size_t min_size);
+
+public:
+    Arena();
+    Arena(const Arena& other) = delete;
+    Arena(Arena&& other) noexcept;
+
+    Arena& operator=(const Arena& other) = delete;
+    Arena& operator=(Arena&& other) noexcept;
+
+    template <typename T, typename... Args>
+    T* Make(Args&&... args) {
+        T* obj = new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+        if constexpr (NEEDS_FINALIZER<T>) {
+            void* mem = Allocate(sizeof(Finalizer), alignof(Finalizer));
+            finalizers_ = new (mem) Finalizer{finalizers_, [](void* ptr) { static_cast<T*>(ptr)->~T(); }, obj};
+        }
+        return obj;
+    }
+
+    // Like Make, but the storage can be handed back with Recycle and is reused by the next
+    // MakeRecyclable of the same size.
+    template <typename T, typename... Args>
+    T* MakeRecyclable(Args&&... args) {
+        static_assert(!NEEDS_FINALIZER<T>, "recycled objects are never finalized");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types cannot be recycled");
+        return new (AllocateSlot(sizeof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // obj must come from MakeRecyclable on this arena and must already be destroyed.
+    void Recycle(void* obj) noexcept;
+
+    // O(log blocks): tells objects built by this arena apart from any other pointer.
+    bool Owns(const void* ptr) const noexcept;
+
+    // Runs one finalizer per object that needs one, so Release is O(blocks) when no object does.
+    void Release() noexcept;
+
+    bool IsEmpty() const noexcept;
+    size_t BlockCount() const noexcept;
+
+    ~Arena();
+};
+
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "figure.hpp"
+#include "vector.hpp"
+
+namespace spatial {
+
+using IndexPair = std::pair<size_t, size_t>;
+
+bool Overlaps(const figure::Figure& a, const figure::Figure& b);
+
+std::vector<IndexPair> OverlappingPairs(const std::vector<const figure::Figure*>& figures, size_t threads = 1);
+std::vector<IndexPair> OverlappingPairs(const vector::Vector& vec, size_t threads = 1);
+
+}
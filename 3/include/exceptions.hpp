@@ -8,4 +8,24 @@ namespace exceptions {
     public:
         explicit InvalidPointsException(const std::string& error): std::runtime_error(error) {}
     };
+
+    class StorageException: public std::runtime_error {
+    public:
+        explicit StorageException(const std::string& error): std::runtime_error(error) {}
+    };
+
+    class FormatException: public std::runtime_error {
+    public:
+        explicit FormatException(const std::string& error): std::runtime_error(error) {}
+    };
+
+    class ParseException: public std::runtime_error {
+        size_t line_;
+
+    public:
+        ParseException(size_t line, const std::string& error)
+            : std::runtime_error("line " + std::to_string(line) + ": " + error), line_(line) {}
+
+        size_t Line() const noexcept { return line_; }
+    };
 }
\ No newline at end of file
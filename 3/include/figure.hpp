@@ -1,6 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <type_traits>
+#include <vector>
 
 namespace figure {
 
@@ -16,17 +21,153 @@ struct Point {
     Point(double _x, double _y);
 };
 
+static_assert(sizeof(Point) == 2 * sizeof(double) && std::is_standard_layout_v<Point>,
+              "kernels read arrays of Point as interleaved x, y doubles");
+
 bool operator==(const Point& val1, const Point& val2);
 bool operator!=(const Point& val1, const Point& val2);
 std::ostream& operator<<(std::ostream& stream, const Point& point);
 std::istream& operator>>(std::istream& stream, Point& point);
 double Distance(const Point& a, const Point& b);
 
+struct Box {
+    double min_x, min_y, max_x, max_y;
+
+    Box();
+    Box(double _min_x, double _min_y, double _max_x, double _max_y);
+
+    bool Overlaps(const Box& other) const;
+    bool Contains(const Point& point) const;
+    double Area() const;
+    Point Center() const;
+    Box Merge(const Box& other) const;
+    double Distance(const Point& point) const;
+};
+
+uint64_t EditEpoch() noexcept;
+uint64_t MarkEdited() noexcept;
+
+// Area and Center may be called concurrently on the same figure: the first caller publishes the value
+// with release ordering, callers that race with it compute their own copy instead of waiting.
+// Editing a figure (SetVertex, operator>>, assignment) still must not overlap with any reader; edits of
+// a figure whose measures were already read stamp it with a fresh EditEpoch value, its Version, so that
+// containers can tell which of their figures changed.
+class MeasureCache {
+#ifdef FIGURE_CACHE
+    template <typename T>
+    class Slot {
+        static constexpr uint8_t EMPTY = 0;
+        static constexpr uint8_t BUSY = 1;
+        static constexpr uint8_t READY = 2;
+
+        T value_{};
+        std::atomic<uint8_t> state_{EMPTY};
+
+    public:
+        Slot() = default;
+
+        Slot(const Slot& other) {
+            *this = other;
+        }
+
+        Slot& operator=(const Slot& other) {
+            if (this != &other) {
+                if (other.state_.load(std::memory_order_acquire) == READY) {
+                    value_ = other.value_;
+                    state_.store(READY, std::memory_order_release);
+                } else {
+                    state_.store(EMPTY, std::memory_order_relaxed);
+                }
+            }
+            return *this;
+        }
+
+        template <typename Func>
+        T Get(Func compute) {
+            if (state_.load(std::memory_order_acquire) == READY) {
+                return value_;
+            }
+            uint8_t expected = EMPTY;
+            if (!state_.compare_exchange_strong(expected, BUSY, std::memory_order_acquire)) {
+                return compute();
+            }
+            value_ = compute();
+            state_.store(READY, std::memory_order_release);
+            return value_;
+        }
+
+        bool Reset() noexcept {
+            return state_.exchange(EMPTY, std::memory_order_relaxed) == READY;
+        }
+    };
+
+    mutable Slot<double> area_;
+    mutable Slot<Point> center_;
+#endif
+    uint64_t version_ = 0;
+
+public:
+    MeasureCache() = default;
+    MeasureCache(const MeasureCache& other) = default;
+
+    MeasureCache& operator=([[maybe_unused]] const MeasureCache& other) {
+        Invalidate();
+#ifdef FIGURE_CACHE
+        area_ = other.area_;
+        center_ = other.center_;
+#endif
+        return *this;
+    }
+
+    template <typename Func>
+    double Area(Func compute) const {
+#ifdef FIGURE_CACHE
+        return area_.Get(compute);
+#else
+        return compute();
+#endif
+    }
+
+    template <typename Func>
+    Point Center(Func compute) const {
+#ifdef FIGURE_CACHE
+        return center_.Get(compute);
+#else
+        return compute();
+#endif
+    }
+
+    void Invalidate() noexcept {
+#ifdef FIGURE_CACHE
+        const bool was_read = area_.Reset();
+        if (center_.Reset() || was_read) {
+            version_ = MarkEdited();
+        }
+#else
+        version_ = MarkEdited();
+#endif
+    }
+
+    uint64_t Version() const noexcept {
+        return version_;
+    }
+};
+
 class Figure {
 public:
     virtual Point Center() const = 0;
     virtual double Area() const = 0;
+    virtual int VertexCount() const = 0;
+    virtual Point GetVertex(int idx) const = 0;
     virtual operator double() = 0;
+    virtual void Contains(const Point* points, size_t count, uint64_t* masks) const;
+    virtual uint64_t Version() const noexcept;
     virtual ~Figure() = default;
+
+    std::vector<uint64_t> Contains(const std::vector<Point>& points) const;
 };
+
+Box Bounds(const Figure& fig);
+bool Contains(const Figure& fig, const Point& point);
+double Distance(const Figure& fig, const Point& point);
 }
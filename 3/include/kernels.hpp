@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace kernels {
+
+template <int N>
+void ShoelaceAreas(const double* const* xs, const double* const* ys, size_t count, double* out);
+
+template <int N>
+void VertexCenters(const double* const* xs, const double* const* ys, size_t count, double* cx, double* cy);
+
+constexpr int MIN_MASK_VERTICES = 3;
+constexpr int MAX_MASK_VERTICES = 8;
+
+template <int N>
+void ContainsMask(const double* vx, const double* vy, const double* points, size_t count, uint64_t* masks);
+
+const char* ActiveIsa() noexcept;
+
+}
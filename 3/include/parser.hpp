@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include "store.hpp"
+
+namespace parser {
+
+store::Store Parse(std::string_view text, size_t threads = 1);
+store::Store ParseFile(const std::string& path, size_t threads = 1);
+
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "figure.hpp"
+#include "kernels.hpp"
+
+namespace figure {
+
+static_assert(sizeof(Point) == 2 * sizeof(double), "points must be packed coordinate pairs");
+
+template <int N>
+class Polygon : public Figure {
+    Point ComputeCenter() const {
+        double cx = 0, cy = 0;
+        Unroll([&](auto i) {
+            cx += points[i].x;
+            cy += points[i].y;
+        });
+        return Point(cx / N, cy / N);
+    }
+
+    double ComputeArea() const {
+        double sum = 0;
+        Unroll([&](auto i) {
+            constexpr int next = (decltype(i)::value + 1) % N;
+            sum += points[i].x * points[next].y - points[next].x * points[i].y;
+        });
+        return std::fabs(sum) / 2;
+    }
+
+protected:
+    Point points[N];
+    [[no_unique_address]] MeasureCache cache_;
+
+    template <typename Func>
+    static constexpr void Unroll(Func&& func) {
+        [&]<int... I>(std::integer_sequence<int, I...>) {
+            (func(std::integral_constant<int, I>{}), ...);
+        }(std::make_integer_sequence<int, N>{});
+    }
+
+    bool HasDistinctVertices() const {
+        bool res = true;
+        Unroll([&](auto i) {
+            constexpr int first = decltype(i)::value;
+            Unroll([&](auto j) {
+                if constexpr (decltype(j)::value > first) {
+                    res &= !((std::fabs(points[i].x - points[j].x) < EPS) & (std::fabs(points[i].y - points[j].y) < EPS));
+                }
+            });
+        });
+        return res;
+    }
+
+public:
+    Polygon() = default;
+
+    explicit Polygon(const std::array<Point, N>& vertices) {
+        Unroll([&](auto i) { points[i] = vertices[i]; });
+    }
+
+    operator double() override {
+        return Area();
+    }
+
+    Point Center() const override {
+        return cache_.Center([this] { return ComputeCenter(); });
+    }
+
+    double Area() const override {
+        return cache_.Area([this] { return ComputeArea(); });
+    }
+
+    int VertexCount() const override {
+        return N;
+    }
+
+    uint64_t Version() const noexcept override {
+        return cache_.Version();
+    }
+
+    Point GetVertex(int idx) const override {
+        if (idx < 0 || idx >= N) {
+            throw std::out_of_range("invalid vertex index");
+        }
+        return points[idx];
+    }
+
+    using Figure::Contains;
+
+    void Contains(const Point* pts, size_t count, uint64_t* masks) const override {
+        if constexpr (N >= kernels::MIN_MASK_VERTICES && N <= kernels::MAX_MASK_VERTICES) {
+            double vx[N], vy[N];
+            Unroll([&](auto i) {
+                vx[i] = points[i].x;
+                vy[i] = points[i].y;
+            });
+            kernels::ContainsMask<N>(vx, vy, &pts->x, count, masks);
+        } else {
+            Figure::Contains(pts, count, masks);
+        }
+    }
+
+    void SetVertex(int idx, const Point& point) {
+        if (idx < 0 || idx >= N) {
+            throw std::out_of_range("invalid vertex index");
+        }
+        points[idx] = point;
+        cache_.Invalidate();
+    }
+
+    bool Equals(const Polygon& other) const {
+        bool res = true;
+        Unroll([&](auto i) {
+            res &= (std::fabs(points[i].x - other.points[i].x) <= EPS) &
+                   (std::fabs(points[i].y - other.points[i].y) <= EPS);
+        });
+        return res;
+    }
+
+    bool IsValid() const {
+        return HasDistinctVertices() && Area() > EPS;
+    }
+
+    friend std::istream& operator>>(std::istream& stream, Polygon& poly) {
+        poly.cache_.Invalidate();
+        Unroll([&](auto i) { stream >> poly.points[i]; });
+        return stream;
+    }
+
+    friend std::ostream& operator<<(std::ostream& stream, const Polygon& poly) {
+        Unroll([&](auto i) { stream << poly.points[i]; });
+        return stream;
+    }
+};
+
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdlib>
+#include <vector>
+
+namespace ranking {
+
+std::vector<size_t> TopK(const std::vector<double>& keys, size_t k);
+
+std::vector<size_t> SortedOrder(const std::vector<double>& keys, size_t threads = 1);
+
+double Percentile(std::vector<double> keys, double q);
+
+}
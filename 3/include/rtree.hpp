@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdlib>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "figure.hpp"
+#include "vector.hpp"
+
+namespace spatial {
+
+class RTree {
+    struct Node;
+
+    struct Entry {
+        figure::Box box;
+        std::unique_ptr<Node> child;
+        const figure::Figure* fig;
+    };
+
+    struct Node {
+        bool leaf = true;
+        std::vector<Entry> entries;
+    };
+
+    static constexpr size_t MAX_ENTRIES = 16;
+    static constexpr size_t MIN_ENTRIES = 6;
+
+    std::unique_ptr<Node> root_;
+    std::unordered_multimap<const figure::Figure*, figure::Box> boxes_;
+    size_t size_;
+
+    static figure::Box NodeBox(const Node& node);
+    static std::vector<Entry> Pack(std::vector<Entry> entries, bool leaf);
+    static std::unique_ptr<Node> InsertEntry(Node& node, Entry entry);
+    static std::unique_ptr<Node> Split(Node& node);
+    static bool EraseEntry(Node& node, const figure::Figure* fig, const figure::Box& box,
+                           std::vector<Entry>& orphans);
+    static void Collect(Node& node, std::vector<Entry>& out);
+    void InsertLeaf(Entry entry);
+    static void Search(const Node& node, const figure::Box& box, std::vector<const figure::Figure*>& out);
+    static void Search(const Node& node, const figure::Point& point, std::vector<const figure::Figure*>& out);
+
+public:
+    RTree();
+    explicit RTree(const vector::Vector& vec);
+
+    void BulkLoad(const std::vector<const figure::Figure*>& figures);
+    void Insert(const figure::Figure* fig);
+    // Erase locates the figure by the box it had when inserted, so it stays O(log n) even if the
+    // figure was edited since; the tree keeps answering queries with that stale box until then.
+    bool Erase(const figure::Figure* fig);
+    void Clear() noexcept;
+
+    bool IsEmpty() const noexcept;
+    size_t Size() const noexcept;
+
+    std::vector<const figure::Figure*> Range(const figure::Box& box) const;
+    std::vector<const figure::Figure*> AtPoint(const figure::Point& point) const;
+    const figure::Figure* Nearest(const figure::Point& point) const;
+};
+
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "figure.hpp"
+#include "pentagon.hpp"
+#include "rhombus.hpp"
+#include "trapezoid.hpp"
+#include "variant_vector.hpp"
+#include "vector.hpp"
+
+namespace store {
+
+template <int N>
+struct Batch {
+    std::array<std::vector<double>, N> xs;
+    std::array<std::vector<double>, N> ys;
+    std::array<const double*, N> mapped_xs{};
+    std::array<const double*, N> mapped_ys{};
+    size_t mapped_size = 0;
+    bool is_mapped = false;
+
+    size_t Size() const noexcept {
+        return is_mapped ? mapped_size : xs[0].size();
+    }
+
+    const double* X(int idx) const noexcept {
+        return is_mapped ? mapped_xs[idx] : xs[idx].data();
+    }
+
+    const double* Y(int idx) const noexcept {
+        return is_mapped ? mapped_ys[idx] : ys[idx].data();
+    }
+};
+
+struct Mapping;
+
+class Store {
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint64_t counts[3];
+    };
+
+    static constexpr size_t BLOCK = 256;
+    static constexpr size_t PREFILTER_MIN_FIGURES = 16;
+    static constexpr char FORMAT_MAGIC[9] = "FIGSTORE";
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    Batch<figure::PENTAGON_ANGLES> pentagons_;
+    Batch<figure::RHOMBUS_ANGLES> rhombi_;
+    Batch<figure::TRAPEZOID_ANGLES> trapezoids_;
+    std::shared_ptr<const Mapping> mapping_;
+
+    template <int N, typename Figure>
+    static void Append(Batch<N>& batch, const Figure& fig);
+    template <int N>
+    static void Reserve(Batch<N>& batch, size_t count);
+    template <int N>
+    static void Clear(Batch<N>& batch) noexcept;
+    template <int N>
+    static void Detach(Batch<N>& batch);
+    template <int N>
+    static void Merge(Batch<N>& batch, const Batch<N>& other);
+    template <int N>
+    static const double* MapBatch(Batch<N>& batch, const double* data, size_t count);
+    template <int N>
+    static void WriteBatch(std::ostream& stream, const Batch<N>& batch);
+
+    template <int N>
+    static void Areas(const Batch<N>& batch, size_t from, size_t count, double* out);
+    template <int N>
+    static double SumAreas(const Batch<N>& batch);
+    template <int N>
+    static void Centers(const Batch<N>& batch, figure::Point* out);
+    template <typename Shape, int N>
+    static Shape Get(const Batch<N>& batch, size_t idx);
+    template <int N>
+    static void Contains(const Batch<N>& batch, const double* points, size_t count, uint64_t* masks);
+    template <int N>
+    static void ContainsSorted(const Batch<N>& batch, const double* points, size_t count, uint64_t* masks);
+
+public:
+    Store();
+    explicit Store(const vector::Vector& vec);
+
+    void PushBack(const figure::Pentagon& pent);
+    void PushBack(const figure::Rhombus& rh);
+    void PushBack(const figure::Trapezoid& trap);
+
+    void Merge(const Store& other);
+    void Reserve(size_t pentagons, size_t rhombi, size_t trapezoids);
+    void Clear() noexcept;
+
+    bool IsEmpty() const noexcept;
+    size_t Size() const noexcept;
+    size_t PentagonCount() const noexcept;
+    size_t RhombusCount() const noexcept;
+    size_t TrapezoidCount() const noexcept;
+
+    // Indices used by At, Areas, Centers, TopK and SortByArea run over all pentagons, then all rhombi,
+    // then all trapezoids, each group in insertion order; they are not global insertion order.
+    vector::Shape At(size_t idx) const;
+
+    double TotalArea() const;
+    std::vector<double> Areas() const;
+    std::vector<size_t> TopK(size_t k) const;
+    std::vector<size_t> SortByArea(size_t threads = 1) const;
+    double AreaPercentile(double q) const;
+    std::vector<uint64_t> Contains(const std::vector<figure::Point>& points) const;
+    std::vector<figure::Point> Centers() const;
+
+    bool IsMapped() const noexcept;
+    void WriteBinary(const std::string& path) const;
+    static Store MapBinary(const std::string& path);
+};
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
+#include <variant>
+#include <vector>
+#include "pentagon.hpp"
+#include "rhombus.hpp"
+#include "trapezoid.hpp"
+
+namespace vector {
+
+using Shape = std::variant<figure::Pentagon, figure::Rhombus, figure::Trapezoid>;
+
+class VariantVector {
+    std::vector<Shape> data_;
+
+public:
+    VariantVector();
+    VariantVector(std::initializer_list<Shape> init);
+
+    Shape& operator[](size_t pos);
+    const Shape& operator[](size_t pos) const;
+
+    Shape& Front() noexcept;
+    Shape& Back() noexcept;
+    const Shape* Data() const noexcept;
+
+    bool IsEmpty() const noexcept;
+    size_t Size() const noexcept;
+    size_t Capacity() const noexcept;
+
+    void Reserve(size_t new_cap);
+    void Clear() noexcept;
+    void Insert(size_t pos, const Shape& value);
+    void Erase(size_t begin_pos, size_t end_pos);
+    void Erase(size_t pos);
+    void PushBack(const Shape& value);
+    void PopBack();
+
+    double TotalArea() const;
+    std::vector<double> Areas() const;
+    std::vector<size_t> TopK(size_t k) const;
+    std::vector<size_t> SortByArea(size_t threads = 1) const;
+    double AreaPercentile(double q) const;
+    std::vector<uint64_t> Contains(const std::vector<figure::Point>& points) const;
+    void SeparateCenter() const;
+    void SeparateArea() const;
+};
+
+figure::Point Center(const Shape& shape);
+double Area(const Shape& shape);
+
+}
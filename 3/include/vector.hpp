@@ -1,22 +1,97 @@
 #pragma once
 
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <initializer_list>
+#include <mutex>
 #include <utility>
+#include <vector>
+#include "arena.hpp"
 #include "figure.hpp"
+#include "pentagon.hpp"
+#include "rhombus.hpp"
+#include "trapezoid.hpp"
+
+namespace arena {
+
+// Polygons hold only points and their measure cache, so their virtual destructor has nothing to run.
+static_assert(std::is_trivially_destructible_v<figure::MeasureCache> && std::is_trivially_destructible_v<figure::Point>,
+              "polygon members must not need destruction");
+template <>
+inline constexpr bool NEEDS_FINALIZER<figure::Pentagon> = false;
+template <>
+inline constexpr bool NEEDS_FINALIZER<figure::Rhombus> = false;
+template <>
+inline constexpr bool NEEDS_FINALIZER<figure::Trapezoid> = false;
+
+}
 
 namespace vector {
 
+struct Summary {
+    size_t count = 0;
+    size_t pentagons = 0;
+    size_t rhombi = 0;
+    size_t trapezoids = 0;
+    double total_area = 0;
+    double min_area = 0;
+    double max_area = 0;
+    figure::Box bounds;
+};
+
 class Vector {
     friend void swap(Vector& v1, Vector& v2) noexcept;
+
+    class Aggregates {
+#ifdef VECTOR_AGGREGATES
+        mutable std::mutex mutex_;
+        mutable Summary summary_;
+        mutable double area_comp_ = 0;
+        mutable uint64_t epoch_ = 0;
+        mutable bool is_stale_ = true;
+        bool is_enabled_ = false;
+#endif
+
+        static void Include(Summary& summary, double& comp, const figure::Figure* fig);
+
+    public:
+        Aggregates() = default;
+        Aggregates(const Aggregates& other) noexcept;
+        Aggregates& operator=(const Aggregates& other) noexcept;
+
+        static Summary Scan(figure::Figure* const* data, size_t size);
+
+        void Add(const figure::Figure* fig);
+        void Remove(const figure::Figure* fig);
+        void Enable() noexcept;
+        void Reset() noexcept;
+        void Invalidate() noexcept;
+        Summary Get(figure::Figure* const* data, size_t size) const;
+    };
     
     size_t size_;
     size_t capacity_;
     figure::Figure** data_;
+    arena::Arena arena_;
+    Aggregates aggregates_;
+
+    static constexpr size_t REDUCE_BLOCK = 4096;
+
+    void Drop(figure::Figure* value) noexcept;
+    double SumAreas(size_t begin, size_t end) const;
+    static void NeumaierAdd(double& sum, double& comp, double val) noexcept;
+    static void RunChunks(size_t count, size_t threads, const std::function<void(size_t, size_t)>& func);
     
 public:
     Vector();
     Vector(std::initializer_list<figure::Figure*> init);
+    Vector(const Vector& other) = delete;
+    Vector(Vector&& other) noexcept;
+
+    Vector& operator=(const Vector& other) = delete;
+    Vector& operator=(Vector&& other) noexcept;
     
     figure::Figure& operator[](size_t pos);
     const figure::Figure& operator[](size_t pos) const;
@@ -26,6 +101,7 @@ public:
     figure::Figure** Data() const noexcept;
     
     bool IsEmpty() const noexcept;
+    bool IsOwned(size_t pos) const;
     size_t Size() const noexcept;
     size_t Capacity() const noexcept;
     
@@ -34,10 +110,62 @@ public:
     void Insert(size_t pos, figure::Figure* value);
     void Erase(size_t begin_pos, size_t end_pos);
     void Erase(size_t pos);
+    void InsertRange(size_t pos, figure::Figure* const* values, size_t count);
+
+    // Null entries are kept without calling pred. If pred throws, the figures it already rejected are
+    // removed and every figure from the one it threw on onwards is kept in order.
+    template <typename Pred>
+    size_t EraseIf(Pred pred) {
+        size_t kept = 0;
+        size_t i = 0;
+        try {
+            for (; i < size_; ++i) {
+                figure::Figure* value = data_[i];
+                if (value == nullptr || !pred(static_cast<const figure::Figure&>(*value))) {
+                    data_[kept++] = value;
+                } else {
+                    Drop(value);
+                }
+            }
+        } catch (...) {
+            std::memmove(data_ + kept, data_ + i, (size_ - i) * sizeof(figure::Figure*));
+            size_ = kept + (size_ - i);
+            throw;
+        }
+
+        const size_t removed = size_ - kept;
+        size_ = kept;
+        return removed;
+    }
+
     void PushBack(figure::Figure* value);
     void PopBack();
+
+    // Figures built by Emplace are owned by the Vector's arena: Erase, EraseIf and PopBack destroy them and
+    // the next Emplace of the same type reuses their memory, Clear frees all of them at once. Other figures
+    // are never destroyed by the Vector. An emplaced figure must be stored in the Vector only once.
+    template <typename T, typename... Args>
+    T& Emplace(Args&&... args) {
+        T* value = arena_.MakeRecyclable<T>(std::forward<Args>(args)...);
+        PushBack(value);
+        return *value;
+    }
     
     double TotalArea();
+    double TotalArea(size_t threads) const;
+    std::vector<double> Areas(size_t threads = 1) const;
+    std::vector<size_t> TopK(size_t k) const;
+    std::vector<size_t> SortByArea(size_t threads = 1) const;
+    double AreaPercentile(double q) const;
+    // Summarize scans all figures unless EnableSummary was called, after which the summary is kept up to
+    // date on every insertion and removal. Null entries are skipped. Edits made through SetVertex,
+    // operator>> or assignment stamp the figure's Version; once any figure was edited, Summarize checks
+    // the stamps of this Vector's figures and rescans only if one of them changed. Any other in-place
+    // change to a stored figure requires InvalidateSummary. Summarize may run concurrently with itself.
+    Summary Summarize() const;
+    std::vector<uint64_t> Contains(const std::vector<figure::Point>& points) const;
+    void EnableSummary() noexcept;
+    void InvalidateSummary() noexcept;
     void SeparateCenter();
     void SeparateArea();
     
@@ -25,9 +25,9 @@ int main() {
     std::cout << "Center: " << penta.Center() << "\n\n";
 
     Vector v;
-    v.PushBack(new Trapezoid({0, 0}, {4, 0}, {3, 3}, {1, 3}));
-    v.PushBack(new Rhombus({0, 0}, {2, 1}, {0, 2}, {-2, 1}));
-    v.PushBack(new Pentagon());
+    v.Emplace<Trapezoid>(Point{0, 0}, Point{4, 0}, Point{3, 3}, Point{1, 3});
+    v.Emplace<Rhombus>(Point{0, 0}, Point{2, 1}, Point{0, 2}, Point{-2, 1});
+    v.Emplace<Pentagon>();
     
     std::cout << "Vector size: " << v.Size() << "\n";
     std::cout << "Vector capacity: " << v.Capacity() << "\n";
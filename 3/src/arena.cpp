@@ -0,0 +1,141 @@
+#include "arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+
+namespace arena {
+
+Arena::Arena() : blocks_(nullptr), cur_(nullptr), end_(nullptr), finalizers_(nullptr), block_count_(0) {}
+
+Arena::Arena(Arena&& other) noexcept
+    : blocks_(std::exchange(other.blocks_, nullptr)),
+      cur_(std::exchange(other.cur_, nullptr)),
+      end_(std::exchange(other.end_, nullptr)),
+      finalizers_(std::exchange(other.finalizers_, nullptr)),
+      block_count_(std::exchange(other.block_count_, 0)),
+      sorted_blocks_(std::move(other.sorted_blocks_)),
+      free_lists_(std::move(other.free_lists_)) {
+    other.sorted_blocks_.clear();
+    other.free_lists_.clear();
+}
+
+Arena& Arena::operator=(Arena&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+
+    Release();
+    blocks_ = std::exchange(other.blocks_, nullptr);
+    cur_ = std::exchange(other.cur_, nullptr);
+    end_ = std::exchange(other.end_, nullptr);
+    finalizers_ = std::exchange(other.finalizers_, nullptr);
+    block_count_ = std::exchange(other.block_count_, 0);
+    sorted_blocks_ = std::move(other.sorted_blocks_);
+    free_lists_ = std::move(other.free_lists_);
+    other.sorted_blocks_.clear();
+    other.free_lists_.clear();
+
+    return *this;
+}
+
+void* Arena::Allocate(size_t size, size_t align) {
+    uintptr_t pos = (reinterpret_cast<uintptr_t>(cur_) + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+    if (cur_ == nullptr || pos + size > reinterpret_cast<uintptr_t>(end_)) {
+        NewBlock(size + align);
+        pos = (reinterpret_cast<uintptr_t>(cur_) + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+    }
+
+    cur_ = reinterpret_cast<char*>(pos + size);
+    return reinterpret_cast<void*>(pos);
+}
+
+void* Arena::AllocateSlot(size_t size) {
+    for (FreeList& list : free_lists_) {
+        if (list.size == size && list.head != nullptr) {
+            Slot* slot = list.head;
+            list.head = slot->next;
+            return slot + 1;
+        }
+    }
+
+    Slot* slot = static_cast<Slot*>(Allocate(sizeof(Slot) + size, alignof(Slot)));
+    slot->size = size;
+    slot->next = nullptr;
+    return slot + 1;
+}
+
+void Arena::Recycle(void* obj) noexcept {
+    Slot* slot = static_cast<Slot*>(obj) - 1;
+    for (FreeList& list : free_lists_) {
+        if (list.size == slot->size) {
+            slot->next = list.head;
+            list.head = slot;
+            return;
+        }
+    }
+
+    try {
+        free_lists_.push_back({slot->size, slot});
+    } catch (const std::bad_alloc&) {
+        // The slot is simply not reused; its memory still goes away with the block.
+    }
+}
+
+bool Arena::Owns(const void* ptr) const noexcept {
+    const auto addr = reinterpret_cast<uintptr_t>(ptr);
+    auto it = std::upper_bound(sorted_blocks_.begin(), sorted_blocks_.end(), addr,
+                               [](uintptr_t val, const Block* block) { return val < reinterpret_cast<uintptr_t>(block); });
+    if (it == sorted_blocks_.begin()) {
+        return false;
+    }
+    const Block* block = *--it;
+    return addr < reinterpret_cast<uintptr_t>(block) + block->size;
+}
+
+void Arena::NewBlock(size_t min_size) {
+    const size_t size = std::max(BLOCK_SIZE, min_size + sizeof(Block));
+    sorted_blocks_.reserve(sorted_blocks_.size() + 1);
+    Block* block = static_cast<Block*>(::operator new(size));
+    block->next = blocks_;
+    block->size = size;
+    sorted_blocks_.insert(std::upper_bound(sorted_blocks_.begin(), sorted_blocks_.end(), block, std::less<Block*>()),
+                          block);
+
+    blocks_ = block;
+    cur_ = reinterpret_cast<char*>(block + 1);
+    end_ = reinterpret_cast<char*>(block) + size;
+    ++block_count_;
+}
+
+void Arena::Release() noexcept {
+    for (Finalizer* fin = finalizers_; fin != nullptr; fin = fin->next) {
+        fin->destroy(fin->object);
+    }
+    finalizers_ = nullptr;
+
+    while (blocks_ != nullptr) {
+        Block* next = blocks_->next;
+        ::operator delete(blocks_);
+        blocks_ = next;
+    }
+    cur_ = nullptr;
+    end_ = nullptr;
+    block_count_ = 0;
+    sorted_blocks_.clear();
+    free_lists_.clear();
+}
+
+bool Arena::IsEmpty() const noexcept {
+    return blocks_ == nullptr;
+}
+
+size_t Arena::BlockCount() const noexcept {
+    return block_count_;
+}
+
+Arena::~Arena() {
+    Release();
+}
+
+}
@@ -0,0 +1,237 @@
+#include "collision.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <thread>
+
+namespace spatial {
+
+namespace {
+
+constexpr double BAND_SCALE = 2.0;
+
+struct Entry {
+    figure::Box box;
+    size_t idx;
+};
+
+struct Axis {
+    double x, y;
+    double min, max;
+};
+
+struct Hull {
+    figure::Box box;
+    const figure::Point* points;
+    const Axis* axes;
+    int count;
+};
+
+struct Scene {
+    std::vector<figure::Point> points;
+    std::vector<Axis> axes;
+    std::vector<Hull> hulls;
+};
+
+bool Separates(const Hull& edges, const Hull& other) {
+    for (int i = 0; i < edges.count; ++i) {
+        const Axis& axis = edges.axes[i];
+        double low = INFINITY, high = -INFINITY;
+        for (int j = 0; j < other.count; ++j) {
+            const double proj = other.points[j].x * axis.x + other.points[j].y * axis.y;
+            low = std::min(low, proj);
+            high = std::max(high, proj);
+        }
+
+        if (axis.max < low || high < axis.min) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Intersects(const Hull& a, const Hull& b) {
+    return !Separates(a, b) && !Separates(b, a);
+}
+
+void GatherVertices(const figure::Figure& fig, std::vector<figure::Point>& points, std::vector<size_t>& offsets) {
+    for (int i = 0; i < fig.VertexCount(); ++i) {
+        points.push_back(fig.GetVertex(i));
+    }
+    offsets.push_back(points.size());
+}
+
+Scene BuildScene(const std::vector<figure::Point>& points, const std::vector<size_t>& offsets,
+                 const std::vector<size_t>& order) {
+    Scene scene;
+    scene.points.resize(points.size());
+    scene.axes.resize(points.size());
+    scene.hulls.resize(order.size());
+
+    size_t offset = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const int vertices = static_cast<int>(offsets[order[i] + 1] - offsets[order[i]]);
+        figure::Point* hull_points = scene.points.data() + offset;
+        Axis* axes = scene.axes.data() + offset;
+        Hull& hull = scene.hulls[i];
+        offset += vertices;
+
+        std::copy_n(points.data() + offsets[order[i]], vertices, hull_points);
+        for (int j = 0; j < vertices; ++j) {
+            const figure::Point& vertex = hull_points[j];
+            hull.box = hull.box.Merge(figure::Box(vertex.x, vertex.y, vertex.x, vertex.y));
+        }
+
+        for (int j = 0; j < vertices; ++j) {
+            const figure::Point& a = hull_points[j];
+            const figure::Point& b = hull_points[(j + 1) % vertices];
+            Axis& axis = axes[j];
+            axis = Axis{a.y - b.y, b.x - a.x, INFINITY, -INFINITY};
+            for (int k = 0; k < vertices; ++k) {
+                const double proj = hull_points[k].x * axis.x + hull_points[k].y * axis.y;
+                axis.min = std::min(axis.min, proj);
+                axis.max = std::max(axis.max, proj);
+            }
+
+            const double tolerance = figure::EPS * std::sqrt(axis.x * axis.x + axis.y * axis.y);
+            axis.min -= tolerance;
+            axis.max += tolerance;
+        }
+
+        hull.points = hull_points;
+        hull.axes = axes;
+        hull.count = vertices;
+    }
+    return scene;
+}
+
+}
+
+bool Overlaps(const figure::Figure& a, const figure::Figure& b) {
+    std::vector<figure::Point> points;
+    std::vector<size_t> offsets = {0};
+    GatherVertices(a, points, offsets);
+    GatherVertices(b, points, offsets);
+
+    const Scene scene = BuildScene(points, offsets, {0, 1});
+    return scene.hulls[0].box.Overlaps(scene.hulls[1].box) && Intersects(scene.hulls[0], scene.hulls[1]);
+}
+
+std::vector<IndexPair> OverlappingPairs(const std::vector<const figure::Figure*>& figures, size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    const size_t count = figures.size();
+    std::vector<figure::Point> points;
+    std::vector<size_t> offsets = {0};
+    std::vector<Entry> keys(count);
+    double low = INFINITY, high = -INFINITY, height = 0;
+    for (size_t i = 0; i < count; ++i) {
+        GatherVertices(*figures[i], points, offsets);
+        for (size_t j = offsets[i]; j < offsets[i + 1]; ++j) {
+            keys[i].box = keys[i].box.Merge(figure::Box(points[j].x, points[j].y, points[j].x, points[j].y));
+        }
+        keys[i].idx = i;
+        low = std::min(low, keys[i].box.min_y);
+        high = std::max(high, keys[i].box.max_y);
+        height += keys[i].box.max_y - keys[i].box.min_y;
+    }
+
+    const double band = count == 0 ? 0 : std::max(BAND_SCALE * height / count, (high - low) / count);
+    const size_t bands = band > 0 ? static_cast<size_t>((high - low) / band) + 1 : 1;
+    auto band_of = [&](double y) {
+        return band > 0 ? std::min(bands - 1, static_cast<size_t>((y - low) / band)) : size_t(0);
+    };
+
+    std::sort(keys.begin(), keys.end(), [&](const Entry& e1, const Entry& e2) {
+        const size_t band1 = band_of(e1.box.min_y), band2 = band_of(e2.box.min_y);
+        if (band1 != band2) {
+            return band1 < band2;
+        }
+        return e1.box.min_x < e2.box.min_x || (e1.box.min_x == e2.box.min_x && e1.idx < e2.idx);
+    });
+
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = keys[i].idx;
+    }
+
+    const Scene scene = BuildScene(points, offsets, order);
+    const std::vector<Hull>& hulls = scene.hulls;
+
+    std::vector<size_t> starts(bands + 1, 0);
+    for (const Hull& hull : hulls) {
+        for (size_t b = band_of(hull.box.min_y); b <= band_of(hull.box.max_y); ++b) {
+            ++starts[b + 1];
+        }
+    }
+    for (size_t b = 0; b < bands; ++b) {
+        starts[b + 1] += starts[b];
+    }
+
+    std::vector<Entry> members(starts.back());
+    std::vector<size_t> fill(starts.begin(), starts.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t b = band_of(hulls[i].box.min_y); b <= band_of(hulls[i].box.max_y); ++b) {
+            members[fill[b]++] = Entry{hulls[i].box, i};
+        }
+    }
+
+    auto sweep = [&](size_t first_band, size_t last_band) {
+        std::vector<IndexPair> res;
+        for (size_t b = first_band; b < last_band; ++b) {
+            Entry* entries = members.data() + starts[b];
+            const size_t size = starts[b + 1] - starts[b];
+            std::sort(entries, entries + size, [](const Entry& e1, const Entry& e2) {
+                return e1.box.min_x < e2.box.min_x || (e1.box.min_x == e2.box.min_x && e1.idx < e2.idx);
+            });
+
+            for (size_t i = 0; i < size; ++i) {
+                const figure::Box& cur = entries[i].box;
+                for (size_t j = i + 1; j < size && entries[j].box.min_x <= cur.max_x; ++j) {
+                    const figure::Box& next = entries[j].box;
+                    if (next.min_y > cur.max_y || cur.min_y > next.max_y ||
+                        band_of(std::max(cur.min_y, next.min_y)) != b) {
+                        continue;
+                    }
+
+                    if (Intersects(hulls[entries[i].idx], hulls[entries[j].idx])) {
+                        const size_t idx1 = order[entries[i].idx], idx2 = order[entries[j].idx];
+                        res.emplace_back(std::min(idx1, idx2), std::max(idx1, idx2));
+                    }
+                }
+            }
+        }
+        return res;
+    };
+
+    std::vector<IndexPair> res;
+    if (threads <= 1 || bands < threads) {
+        res = sweep(0, bands);
+    } else {
+        std::vector<std::future<std::vector<IndexPair>>> tasks;
+        const size_t step = (bands + threads - 1) / threads;
+        for (size_t begin = step; begin < bands; begin += step) {
+            tasks.push_back(std::async(std::launch::async, sweep, begin, std::min(begin + step, bands)));
+        }
+        res = sweep(0, std::min(step, bands));
+        for (auto& task : tasks) {
+            std::vector<IndexPair> part = task.get();
+            res.insert(res.end(), part.begin(), part.end());
+        }
+    }
+
+    return res;
+}
+
+std::vector<IndexPair> OverlappingPairs(const vector::Vector& vec, size_t threads) {
+    std::vector<const figure::Figure*> figures(vec.Size());
+    for (size_t i = 0; i < vec.Size(); ++i) {
+        figures[i] = &vec[i];
+    }
+    return OverlappingPairs(figures, threads);
+}
+
+}
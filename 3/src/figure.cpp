@@ -1,9 +1,26 @@
 #include "figure.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <limits>
 
 namespace figure {
 
+namespace {
+
+std::atomic<uint64_t> edit_epoch{0};
+
+}
+
+uint64_t EditEpoch() noexcept {
+    return edit_epoch.load(std::memory_order_relaxed);
+}
+
+uint64_t MarkEdited() noexcept {
+    return edit_epoch.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
 Point::Point() : x(0), y(0) {}
 Point::Point(double _x, double _y) : x(_x), y(_y) {}
 
@@ -29,4 +46,97 @@ double Distance(const Point& a, const Point& b) {
     return std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y));
 }
 
+Box::Box()
+    : min_x(std::numeric_limits<double>::infinity()), min_y(std::numeric_limits<double>::infinity()),
+      max_x(-std::numeric_limits<double>::infinity()), max_y(-std::numeric_limits<double>::infinity()) {}
+
+Box::Box(double _min_x, double _min_y, double _max_x, double _max_y)
+    : min_x(_min_x), min_y(_min_y), max_x(_max_x), max_y(_max_y) {}
+
+bool Box::Overlaps(const Box& other) const {
+    return min_x <= other.max_x && other.min_x <= max_x && min_y <= other.max_y && other.min_y <= max_y;
+}
+
+bool Box::Contains(const Point& point) const {
+    return min_x <= point.x && point.x <= max_x && min_y <= point.y && point.y <= max_y;
+}
+
+double Box::Area() const {
+    if (max_x < min_x || max_y < min_y) {
+        return 0;
+    }
+    return (max_x - min_x) * (max_y - min_y);
+}
+
+Point Box::Center() const {
+    return Point((min_x + max_x) / 2, (min_y + max_y) / 2);
+}
+
+Box Box::Merge(const Box& other) const {
+    return Box(std::min(min_x, other.min_x), std::min(min_y, other.min_y), std::max(max_x, other.max_x),
+               std::max(max_y, other.max_y));
+}
+
+double Box::Distance(const Point& point) const {
+    double dx = std::max({min_x - point.x, 0.0, point.x - max_x});
+    double dy = std::max({min_y - point.y, 0.0, point.y - max_y});
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+Box Bounds(const Figure& fig) {
+    Box box;
+    for (int i = 0; i < fig.VertexCount(); ++i) {
+        Point vertex = fig.GetVertex(i);
+        box = box.Merge(Box(vertex.x, vertex.y, vertex.x, vertex.y));
+    }
+    return box;
+}
+
+bool Contains(const Figure& fig, const Point& point) {
+    bool has_pos = false, has_neg = false;
+    for (int i = 0; i < fig.VertexCount(); ++i) {
+        Point a = fig.GetVertex(i);
+        Point b = fig.GetVertex((i + 1) % fig.VertexCount());
+        double cross = (b.x - a.x) * (point.y - a.y) - (b.y - a.y) * (point.x - a.x);
+
+        has_pos = has_pos || cross > EPS;
+        has_neg = has_neg || cross < -EPS;
+    }
+    return !(has_pos && has_neg);
+}
+
+uint64_t Figure::Version() const noexcept {
+    return 0;
+}
+
+void Figure::Contains(const Point* points, size_t count, uint64_t* masks) const {
+    for (size_t j = 0; j < count; ++j) {
+        masks[j / 64] |= uint64_t(figure::Contains(*this, points[j])) << (j % 64);
+    }
+}
+
+std::vector<uint64_t> Figure::Contains(const std::vector<Point>& points) const {
+    std::vector<uint64_t> masks((points.size() + 63) / 64, 0);
+    Contains(points.data(), points.size(), masks.data());
+    return masks;
+}
+
+double Distance(const Figure& fig, const Point& point) {
+    if (Contains(fig, point)) {
+        return 0;
+    }
+
+    double res = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < fig.VertexCount(); ++i) {
+        Point a = fig.GetVertex(i);
+        Point b = fig.GetVertex((i + 1) % fig.VertexCount());
+
+        double dx = b.x - a.x, dy = b.y - a.y;
+        double len = dx * dx + dy * dy;
+        double t = len > 0 ? std::clamp(((point.x - a.x) * dx + (point.y - a.y) * dy) / len, 0.0, 1.0) : 0.0;
+        res = std::min(res, Distance(point, Point(a.x + t * dx, a.y + t * dy)));
+    }
+    return res;
+}
+
 }
@@ -0,0 +1,298 @@
+#include "kernels.hpp"
+#include "figure.hpp"
+
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KERNELS_X86
+#endif
+
+namespace kernels {
+
+namespace {
+
+enum class Isa { Scalar, Avx2, Avx512 };
+
+Isa DetectIsa() noexcept {
+#ifdef KERNELS_X86
+    if (__builtin_cpu_supports("avx512f")) {
+        return Isa::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::Avx2;
+    }
+#endif
+    return Isa::Scalar;
+}
+
+Isa CurrentIsa() noexcept {
+    static const Isa isa = DetectIsa();
+    return isa;
+}
+
+template <int N>
+void ShoelaceScalar(const double* const* xs, const double* const* ys, size_t from, size_t count, double* out) {
+    for (size_t j = from; j < count; ++j) {
+        double sum = 0;
+        for (int i = 0; i < N; ++i) {
+            const int next = (i + 1) % N;
+            sum += xs[i][j] * ys[next][j] - xs[next][j] * ys[i][j];
+        }
+        out[j] = std::fabs(sum) / 2;
+    }
+}
+
+template <int N>
+void CentersScalar(const double* const* xs, const double* const* ys, size_t from, size_t count, double* cx,
+                   double* cy) {
+    for (size_t j = from; j < count; ++j) {
+        double sx = 0, sy = 0;
+        for (int i = 0; i < N; ++i) {
+            sx += xs[i][j];
+            sy += ys[i][j];
+        }
+        cx[j] = sx / N;
+        cy[j] = sy / N;
+    }
+}
+
+template <int N>
+void ContainsScalar(const double* vx, const double* vy, const double* points, size_t from, size_t count,
+                    uint64_t* masks) {
+    for (size_t j = from; j < count; ++j) {
+        const double px = points[2 * j], py = points[2 * j + 1];
+        bool has_pos = false, has_neg = false;
+        for (int i = 0; i < N; ++i) {
+            const int next = (i + 1) % N;
+            const double cross = (vx[next] - vx[i]) * (py - vy[i]) - (vy[next] - vy[i]) * (px - vx[i]);
+            has_pos = has_pos || cross > figure::EPS;
+            has_neg = has_neg || cross < -figure::EPS;
+        }
+        masks[j / 64] |= uint64_t(!(has_pos && has_neg)) << (j % 64);
+    }
+}
+
+#ifdef KERNELS_X86
+template <int N>
+__attribute__((target("avx2"))) size_t ShoelaceAvx2(const double* const* xs, const double* const* ys, size_t count,
+                                                    double* out) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d half = _mm256_set1_pd(0.5);
+
+    size_t j = 0;
+    for (; j + 4 <= count; j += 4) {
+        __m256d sum = _mm256_setzero_pd();
+        for (int i = 0; i < N; ++i) {
+            const int next = (i + 1) % N;
+            __m256d lhs = _mm256_mul_pd(_mm256_loadu_pd(xs[i] + j), _mm256_loadu_pd(ys[next] + j));
+            __m256d rhs = _mm256_mul_pd(_mm256_loadu_pd(xs[next] + j), _mm256_loadu_pd(ys[i] + j));
+            sum = _mm256_add_pd(sum, _mm256_sub_pd(lhs, rhs));
+        }
+        _mm256_storeu_pd(out + j, _mm256_mul_pd(_mm256_andnot_pd(sign, sum), half));
+    }
+    return j;
+}
+
+template <int N>
+__attribute__((target("avx512f"))) size_t ShoelaceAvx512(const double* const* xs, const double* const* ys,
+                                                         size_t count, double* out) {
+    const __m512d half = _mm512_set1_pd(0.5);
+
+    size_t j = 0;
+    for (; j + 8 <= count; j += 8) {
+        __m512d sum = _mm512_setzero_pd();
+        for (int i = 0; i < N; ++i) {
+            const int next = (i + 1) % N;
+            __m512d lhs = _mm512_mul_pd(_mm512_loadu_pd(xs[i] + j), _mm512_loadu_pd(ys[next] + j));
+            __m512d rhs = _mm512_mul_pd(_mm512_loadu_pd(xs[next] + j), _mm512_loadu_pd(ys[i] + j));
+            sum = _mm512_add_pd(sum, _mm512_sub_pd(lhs, rhs));
+        }
+        _mm512_storeu_pd(out + j, _mm512_mul_pd(_mm512_abs_pd(sum), half));
+    }
+    return j;
+}
+
+template <int N>
+__attribute__((target("avx2"))) size_t CentersAvx2(const double* const* xs, const double* const* ys, size_t count,
+                                                   double* cx, double* cy) {
+    const __m256d scale = _mm256_set1_pd(N);
+
+    size_t j = 0;
+    for (; j + 4 <= count; j += 4) {
+        __m256d sx = _mm256_setzero_pd();
+        __m256d sy = _mm256_setzero_pd();
+        for (int i = 0; i < N; ++i) {
+            sx = _mm256_add_pd(sx, _mm256_loadu_pd(xs[i] + j));
+            sy = _mm256_add_pd(sy, _mm256_loadu_pd(ys[i] + j));
+        }
+        _mm256_storeu_pd(cx + j, _mm256_div_pd(sx, scale));
+        _mm256_storeu_pd(cy + j, _mm256_div_pd(sy, scale));
+    }
+    return j;
+}
+
+template <int N>
+__attribute__((target("avx512f"))) size_t CentersAvx512(const double* const* xs, const double* const* ys,
+                                                        size_t count, double* cx, double* cy) {
+    const __m512d scale = _mm512_set1_pd(N);
+
+    size_t j = 0;
+    for (; j + 8 <= count; j += 8) {
+        __m512d sx = _mm512_setzero_pd();
+        __m512d sy = _mm512_setzero_pd();
+        for (int i = 0; i < N; ++i) {
+            sx = _mm512_add_pd(sx, _mm512_loadu_pd(xs[i] + j));
+            sy = _mm512_add_pd(sy, _mm512_loadu_pd(ys[i] + j));
+        }
+        _mm512_storeu_pd(cx + j, _mm512_div_pd(sx, scale));
+        _mm512_storeu_pd(cy + j, _mm512_div_pd(sy, scale));
+    }
+    return j;
+}
+
+template <int N>
+__attribute__((target("avx2"))) size_t ContainsAvx2(const double* vx, const double* vy, const double* points,
+                                                    size_t count, uint64_t* masks) {
+    const __m256d pos_eps = _mm256_set1_pd(figure::EPS);
+    const __m256d neg_eps = _mm256_set1_pd(-figure::EPS);
+
+    size_t j = 0;
+    for (; j + 4 <= count; j += 4) {
+        const __m256d lo = _mm256_loadu_pd(points + 2 * j);
+        const __m256d hi = _mm256_loadu_pd(points + 2 * j + 4);
+        const __m256d px = _mm256_permute4x64_pd(_mm256_unpacklo_pd(lo, hi), 0xD8);
+        const __m256d py = _mm256_permute4x64_pd(_mm256_unpackhi_pd(lo, hi), 0xD8);
+
+        __m256d pos = _mm256_setzero_pd();
+        __m256d neg = _mm256_setzero_pd();
+        for (int i = 0; i < N; ++i) {
+            const int next = (i + 1) % N;
+            const __m256d ex = _mm256_set1_pd(vx[next] - vx[i]);
+            const __m256d ey = _mm256_set1_pd(vy[next] - vy[i]);
+            const __m256d dx = _mm256_sub_pd(px, _mm256_set1_pd(vx[i]));
+            const __m256d dy = _mm256_sub_pd(py, _mm256_set1_pd(vy[i]));
+            const __m256d cross = _mm256_sub_pd(_mm256_mul_pd(ex, dy), _mm256_mul_pd(ey, dx));
+            pos = _mm256_or_pd(pos, _mm256_cmp_pd(cross, pos_eps, _CMP_GT_OQ));
+            neg = _mm256_or_pd(neg, _mm256_cmp_pd(cross, neg_eps, _CMP_LT_OQ));
+        }
+
+        const uint64_t inside = ~_mm256_movemask_pd(_mm256_and_pd(pos, neg)) & 0xF;
+        masks[j / 64] |= inside << (j % 64);
+    }
+    return j;
+}
+
+template <int N>
+__attribute__((target("avx512f"))) size_t ContainsAvx512(const double* vx, const double* vy, const double* points,
+                                                         size_t count, uint64_t* masks) {
+    const __m512d pos_eps = _mm512_set1_pd(figure::EPS);
+    const __m512d neg_eps = _mm512_set1_pd(-figure::EPS);
+    const __m512i even = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0);
+    const __m512i odd = _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1);
+
+    size_t j = 0;
+    for (; j + 8 <= count; j += 8) {
+        const __m512d lo = _mm512_loadu_pd(points + 2 * j);
+        const __m512d hi = _mm512_loadu_pd(points + 2 * j + 8);
+        const __m512d px = _mm512_permutex2var_pd(lo, even, hi);
+        const __m512d py = _mm512_permutex2var_pd(lo, odd, hi);
+
+        __mmask8 pos = 0, neg = 0;
+        for (int i = 0; i < N; ++i) {
+            const int next = (i + 1) % N;
+            const __m512d ex = _mm512_set1_pd(vx[next] - vx[i]);
+            const __m512d ey = _mm512_set1_pd(vy[next] - vy[i]);
+            const __m512d dx = _mm512_sub_pd(px, _mm512_set1_pd(vx[i]));
+            const __m512d dy = _mm512_sub_pd(py, _mm512_set1_pd(vy[i]));
+            const __m512d cross = _mm512_sub_pd(_mm512_mul_pd(ex, dy), _mm512_mul_pd(ey, dx));
+            pos |= _mm512_cmp_pd_mask(cross, pos_eps, _CMP_GT_OQ);
+            neg |= _mm512_cmp_pd_mask(cross, neg_eps, _CMP_LT_OQ);
+        }
+
+        const uint64_t inside = static_cast<uint8_t>(~(pos & neg));
+        masks[j / 64] |= inside << (j % 64);
+    }
+    return j;
+}
+#endif
+
+}
+
+template <int N>
+void ShoelaceAreas(const double* const* xs, const double* const* ys, size_t count, double* out) {
+    size_t done = 0;
+#ifdef KERNELS_X86
+    switch (CurrentIsa()) {
+    case Isa::Avx512:
+        done = ShoelaceAvx512<N>(xs, ys, count, out);
+        break;
+    case Isa::Avx2:
+        done = ShoelaceAvx2<N>(xs, ys, count, out);
+        break;
+    case Isa::Scalar:
+        break;
+    }
+#endif
+    ShoelaceScalar<N>(xs, ys, done, count, out);
+}
+
+template <int N>
+void VertexCenters(const double* const* xs, const double* const* ys, size_t count, double* cx, double* cy) {
+    size_t done = 0;
+#ifdef KERNELS_X86
+    switch (CurrentIsa()) {
+    case Isa::Avx512:
+        done = CentersAvx512<N>(xs, ys, count, cx, cy);
+        break;
+    case Isa::Avx2:
+        done = CentersAvx2<N>(xs, ys, count, cx, cy);
+        break;
+    case Isa::Scalar:
+        break;
+    }
+#endif
+    CentersScalar<N>(xs, ys, done, count, cx, cy);
+}
+
+template <int N>
+void ContainsMask(const double* vx, const double* vy, const double* points, size_t count, uint64_t* masks) {
+    size_t done = 0;
+#ifdef KERNELS_X86
+    switch (CurrentIsa()) {
+    case Isa::Avx512:
+        done = ContainsAvx512<N>(vx, vy, points, count, masks);
+        break;
+    case Isa::Avx2:
+        done = ContainsAvx2<N>(vx, vy, points, count, masks);
+        break;
+    case Isa::Scalar:
+        break;
+    }
+#endif
+    ContainsScalar<N>(vx, vy, points, done, count, masks);
+}
+
+const char* ActiveIsa() noexcept {
+    switch (CurrentIsa()) {
+    case Isa::Avx512:
+        return "avx512";
+    case Isa::Avx2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+template void ShoelaceAreas<4>(const double* const*, const double* const*, size_t, double*);
+template void ShoelaceAreas<5>(const double* const*, const double* const*, size_t, double*);
+template void VertexCenters<4>(const double* const*, const double* const*, size_t, double*, double*);
+template void VertexCenters<5>(const double* const*, const double* const*, size_t, double*, double*);
+template void ContainsMask<3>(const double*, const double*, const double*, size_t, uint64_t*);
+template void ContainsMask<4>(const double*, const double*, const double*, size_t, uint64_t*);
+template void ContainsMask<5>(const double*, const double*, const double*, size_t, uint64_t*);
+template void ContainsMask<6>(const double*, const double*, const double*, size_t, uint64_t*);
+template void ContainsMask<7>(const double*, const double*, const double*, size_t, uint64_t*);
+template void ContainsMask<8>(const double*, const double*, const double*, size_t, uint64_t*);
+
+}
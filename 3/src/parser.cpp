@@ -0,0 +1,192 @@
+#include "parser.hpp"
+#include "exceptions.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace parser {
+
+namespace {
+
+constexpr int MAX_COORDS = 2 * figure::PENTAGON_ANGLES;
+
+struct Chunk {
+    std::string_view text;
+    store::Store store;
+    size_t lines = 0;
+    size_t error_line = 0;
+    std::string error;
+};
+
+bool IsSeparator(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\r' || ch == ',' || ch == '(' || ch == ')';
+}
+
+const char* SkipSeparators(const char* cur, const char* end) {
+    while (cur != end && IsSeparator(*cur)) {
+        ++cur;
+    }
+    return cur;
+}
+
+template <typename Shape>
+bool AddShape(const double* vals, store::Store& res, std::string& error) {
+    Shape shape;
+    for (int i = 0; i < shape.VertexCount(); ++i) {
+        shape.SetVertex(i, figure::Point(vals[2 * i], vals[2 * i + 1]));
+    }
+
+    if (!shape.IsValid()) {
+        error = "vertices do not form a valid figure";
+        return false;
+    }
+    res.PushBack(shape);
+    return true;
+}
+
+bool ParseLine(std::string_view line, store::Store& res, std::string& error) {
+    const char* cur = SkipSeparators(line.data(), line.data() + line.size());
+    const char* end = line.data() + line.size();
+    if (cur == end || *cur == '#') {
+        return true;
+    }
+
+    const char* word = cur;
+    while (cur != end && !IsSeparator(*cur)) {
+        ++cur;
+    }
+    const std::string_view kind(word, cur - word);
+
+    int coords = 0;
+    if (kind == "pentagon") {
+        coords = 2 * figure::PENTAGON_ANGLES;
+    } else if (kind == "rhombus") {
+        coords = 2 * figure::RHOMBUS_ANGLES;
+    } else if (kind == "trapezoid") {
+        coords = 2 * figure::TRAPEZOID_ANGLES;
+    } else {
+        error = "unknown figure kind '" + std::string(kind) + "'";
+        return false;
+    }
+
+    double vals[MAX_COORDS];
+    for (int i = 0; i < coords; ++i) {
+        cur = SkipSeparators(cur, end);
+        if (cur == end) {
+            error = "expected " + std::to_string(coords) + " coordinates, got " + std::to_string(i);
+            return false;
+        }
+
+        auto [ptr, ec] = std::from_chars(cur, end, vals[i]);
+        if (ec != std::errc() || (ptr != end && !IsSeparator(*ptr))) {
+            error = "invalid number '" + std::string(cur, std::find_if(cur, end, IsSeparator)) + "'";
+            return false;
+        }
+        if (!std::isfinite(vals[i])) {
+            error = "non-finite number '" + std::string(cur, ptr) + "'";
+            return false;
+        }
+        cur = ptr;
+    }
+
+    cur = SkipSeparators(cur, end);
+    if (cur != end && *cur != '#') {
+        error = "unexpected trailing characters";
+        return false;
+    }
+
+    if (kind == "pentagon") {
+        return AddShape<figure::Pentagon>(vals, res, error);
+    }
+    if (kind == "rhombus") {
+        return AddShape<figure::Rhombus>(vals, res, error);
+    }
+    return AddShape<figure::Trapezoid>(vals, res, error);
+}
+
+void ParseChunk(Chunk& chunk) {
+    size_t pos = 0;
+    while (pos < chunk.text.size()) {
+        size_t end = chunk.text.find('\n', pos);
+        if (end == std::string_view::npos) {
+            end = chunk.text.size();
+        }
+
+        ++chunk.lines;
+        if (!ParseLine(chunk.text.substr(pos, end - pos), chunk.store, chunk.error)) {
+            chunk.error_line = chunk.lines;
+            return;
+        }
+        pos = end + 1;
+    }
+}
+
+}
+
+store::Store Parse(std::string_view text, size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<Chunk> chunks;
+    const size_t step = text.size() / threads + 1;
+    for (size_t begin = 0; begin < text.size();) {
+        size_t end = std::min(text.size(), begin + step);
+        end = end == text.size() ? end : text.find('\n', end);
+        end = end == std::string_view::npos ? text.size() : end + 1;
+
+        chunks.emplace_back();
+        chunks.back().text = text.substr(begin, end - begin);
+        begin = end;
+    }
+
+    std::vector<std::future<void>> tasks;
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        tasks.push_back(std::async(std::launch::async, ParseChunk, std::ref(chunks[i])));
+    }
+    if (!chunks.empty()) {
+        ParseChunk(chunks[0]);
+    }
+    for (auto& task : tasks) {
+        task.get();
+    }
+
+    store::Store res;
+    size_t line = 0;
+    for (Chunk& chunk : chunks) {
+        if (chunk.error_line != 0) {
+            throw exceptions::ParseException(line + chunk.error_line, chunk.error);
+        }
+        line += chunk.lines;
+
+        if (res.IsEmpty()) {
+            res = std::move(chunk.store);
+        } else {
+            res.Merge(chunk.store);
+        }
+    }
+    return res;
+}
+
+store::Store ParseFile(const std::string& path, size_t threads) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        throw exceptions::StorageException("cannot open " + path);
+    }
+
+    std::string text;
+    stream.seekg(0, std::ios::end);
+    text.resize(static_cast<size_t>(stream.tellg()));
+    stream.seekg(0, std::ios::beg);
+    stream.read(text.data(), static_cast<std::streamsize>(text.size()));
+
+    return Parse(text, threads);
+}
+
+}
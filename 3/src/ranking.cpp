@@ -0,0 +1,122 @@
+#include "ranking.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+namespace ranking {
+
+namespace {
+
+constexpr size_t MIN_SORT_CHUNK = 1 << 14;
+constexpr size_t HEAP_SELECT_RATIO = 64;
+
+std::vector<size_t> Identity(size_t count) {
+    std::vector<size_t> res(count);
+    std::iota(res.begin(), res.end(), size_t(0));
+    return res;
+}
+
+}
+
+std::vector<size_t> TopK(const std::vector<double>& keys, size_t k) {
+    k = std::min(k, keys.size());
+    auto greater = [&keys](size_t a, size_t b) {
+        return keys[a] > keys[b] || (keys[a] == keys[b] && a < b);
+    };
+
+    std::vector<size_t> res;
+    if (k == 0) {
+        return res;
+    }
+
+    if (k <= keys.size() / HEAP_SELECT_RATIO) {
+        res.reserve(k + 1);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (res.size() == k && !greater(i, res.front())) {
+                continue;
+            }
+            res.push_back(i);
+            std::push_heap(res.begin(), res.end(), greater);
+            if (res.size() > k) {
+                std::pop_heap(res.begin(), res.end(), greater);
+                res.pop_back();
+            }
+        }
+    } else {
+        res = Identity(keys.size());
+        std::nth_element(res.begin(), res.begin() + k, res.end(), greater);
+        res.resize(k);
+    }
+
+    std::sort(res.begin(), res.end(), greater);
+    return res;
+}
+
+std::vector<size_t> SortedOrder(const std::vector<double>& keys, size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::max<size_t>(1, std::min(threads, keys.size() / MIN_SORT_CHUNK));
+
+    auto less = [&keys](size_t a, size_t b) {
+        return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+    };
+
+    std::vector<size_t> res = Identity(keys.size());
+    std::vector<size_t> bounds;
+    for (size_t i = 0; i <= threads; ++i) {
+        bounds.push_back(res.size() * i / threads);
+    }
+
+    std::vector<std::future<void>> tasks;
+    for (size_t i = 1; i < threads; ++i) {
+        tasks.push_back(std::async(std::launch::async, [&, i] {
+            std::sort(res.begin() + bounds[i], res.begin() + bounds[i + 1], less);
+        }));
+    }
+    std::sort(res.begin(), res.begin() + bounds[1], less);
+    for (auto& task : tasks) {
+        task.get();
+    }
+
+    for (size_t width = 1; width < threads; width *= 2) {
+        tasks.clear();
+        for (size_t i = 0; i + width < threads; i += 2 * width) {
+            const size_t begin = bounds[i], mid = bounds[i + width], end = bounds[std::min(i + 2 * width, threads)];
+            tasks.push_back(std::async(std::launch::async, [&, begin, mid, end] {
+                std::inplace_merge(res.begin() + begin, res.begin() + mid, res.begin() + end, less);
+            }));
+        }
+        for (auto& task : tasks) {
+            task.get();
+        }
+    }
+
+    return res;
+}
+
+double Percentile(std::vector<double> keys, double q) {
+    if (keys.empty()) {
+        throw std::invalid_argument("percentile of an empty collection");
+    }
+    if (!(q >= 0 && q <= 100)) {
+        throw std::invalid_argument("percentile must be in [0, 100]");
+    }
+
+    const double rank = q / 100 * static_cast<double>(keys.size() - 1);
+    const size_t lower = static_cast<size_t>(std::floor(rank));
+    std::nth_element(keys.begin(), keys.begin() + lower, keys.end());
+    const double low = keys[lower];
+    if (lower + 1 == keys.size()) {
+        return low;
+    }
+
+    const double high = *std::min_element(keys.begin() + lower + 1, keys.end());
+    return low + (high - low) * (rank - static_cast<double>(lower));
+}
+
+}
@@ -0,0 +1,331 @@
+#include "rtree.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+namespace spatial {
+
+RTree::RTree() : root_(nullptr), size_(0) {}
+
+RTree::RTree(const vector::Vector& vec) : RTree() {
+    std::vector<const figure::Figure*> figures;
+    figures.reserve(vec.Size());
+    for (size_t i = 0; i < vec.Size(); ++i) {
+        figures.push_back(&vec[i]);
+    }
+    BulkLoad(figures);
+}
+
+void RTree::BulkLoad(const std::vector<const figure::Figure*>& figures) {
+    std::vector<Entry> entries;
+    entries.reserve(figures.size());
+    for (const figure::Figure* fig : figures) {
+        entries.push_back({figure::Bounds(*fig), nullptr, fig});
+    }
+
+    root_.reset();
+    boxes_.clear();
+    boxes_.reserve(entries.size());
+    for (const Entry& entry : entries) {
+        boxes_.emplace(entry.fig, entry.box);
+    }
+    size_ = entries.size();
+    if (entries.empty()) {
+        return;
+    }
+
+    bool leaf = true;
+    while (true) {
+        std::vector<Entry> parents = Pack(std::move(entries), leaf);
+        if (parents.size() == 1) {
+            root_ = std::move(parents[0].child);
+            return;
+        }
+        entries = std::move(parents);
+        leaf = false;
+    }
+}
+
+void RTree::Insert(const figure::Figure* fig) {
+    figure::Box box = figure::Bounds(*fig);
+    boxes_.emplace(fig, box);
+    InsertLeaf({box, nullptr, fig});
+}
+
+void RTree::InsertLeaf(Entry entry) {
+    if (!root_) {
+        root_ = std::make_unique<Node>();
+    }
+
+    std::unique_ptr<Node> sibling = InsertEntry(*root_, std::move(entry));
+    if (sibling) {
+        auto root = std::make_unique<Node>();
+        root->leaf = false;
+        figure::Box old_box = NodeBox(*root_);
+        figure::Box new_box = NodeBox(*sibling);
+        root->entries.push_back({old_box, std::move(root_), nullptr});
+        root->entries.push_back({new_box, std::move(sibling), nullptr});
+        root_ = std::move(root);
+    }
+    ++size_;
+}
+
+bool RTree::Erase(const figure::Figure* fig) {
+    auto it = boxes_.find(fig);
+    if (it == boxes_.end()) {
+        return false;
+    }
+
+    std::vector<Entry> orphans;
+    if (!EraseEntry(*root_, fig, it->second, orphans)) {
+        return false;
+    }
+    boxes_.erase(it);
+
+    while (!root_->leaf && root_->entries.size() == 1) {
+        std::unique_ptr<Node> child = std::move(root_->entries[0].child);
+        root_ = std::move(child);
+    }
+    if (root_->entries.empty()) {
+        root_.reset();
+    }
+
+    size_ -= orphans.size() + 1;
+    for (Entry& orphan : orphans) {
+        InsertLeaf(std::move(orphan));
+    }
+    return true;
+}
+
+void RTree::Clear() noexcept {
+    root_.reset();
+    boxes_.clear();
+    size_ = 0;
+}
+
+bool RTree::IsEmpty() const noexcept {
+    return size_ == 0;
+}
+
+size_t RTree::Size() const noexcept {
+    return size_;
+}
+
+std::vector<const figure::Figure*> RTree::Range(const figure::Box& box) const {
+    std::vector<const figure::Figure*> res;
+    if (root_) {
+        Search(*root_, box, res);
+    }
+    return res;
+}
+
+std::vector<const figure::Figure*> RTree::AtPoint(const figure::Point& point) const {
+    std::vector<const figure::Figure*> res;
+    if (root_) {
+        Search(*root_, point, res);
+    }
+    return res;
+}
+
+const figure::Figure* RTree::Nearest(const figure::Point& point) const {
+    struct Candidate {
+        double dist;
+        const Node* node;
+        const figure::Figure* fig;
+        bool exact;
+
+        bool operator>(const Candidate& other) const {
+            return dist > other.dist;
+        }
+    };
+
+    if (!root_) {
+        return nullptr;
+    }
+
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> queue;
+    queue.push({0, root_.get(), nullptr, false});
+
+    while (!queue.empty()) {
+        Candidate top = queue.top();
+        queue.pop();
+
+        if (top.fig != nullptr) {
+            if (top.exact) {
+                return top.fig;
+            }
+            queue.push({figure::Distance(*top.fig, point), nullptr, top.fig, true});
+            continue;
+        }
+
+        for (const Entry& entry : top.node->entries) {
+            queue.push({entry.box.Distance(point), entry.child.get(), entry.fig, false});
+        }
+    }
+    return nullptr;
+}
+
+figure::Box RTree::NodeBox(const Node& node) {
+    figure::Box box;
+    for (const Entry& entry : node.entries) {
+        box = box.Merge(entry.box);
+    }
+    return box;
+}
+
+std::vector<RTree::Entry> RTree::Pack(std::vector<Entry> entries, bool leaf) {
+    const size_t nodes = (entries.size() + MAX_ENTRIES - 1) / MAX_ENTRIES;
+    const size_t slices = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(nodes))));
+    const size_t slice_size = slices * MAX_ENTRIES;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.box.Center().x < b.box.Center().x;
+    });
+
+    std::vector<Entry> parents;
+    parents.reserve(nodes);
+    for (size_t begin = 0; begin < entries.size(); begin += slice_size) {
+        const size_t end = std::min(entries.size(), begin + slice_size);
+        std::sort(entries.begin() + begin, entries.begin() + end, [](const Entry& a, const Entry& b) {
+            return a.box.Center().y < b.box.Center().y;
+        });
+
+        for (size_t i = begin; i < end; i += MAX_ENTRIES) {
+            auto node = std::make_unique<Node>();
+            node->leaf = leaf;
+            for (size_t j = i; j < std::min(end, i + MAX_ENTRIES); ++j) {
+                node->entries.push_back(std::move(entries[j]));
+            }
+
+            figure::Box box = NodeBox(*node);
+            parents.push_back({box, std::move(node), nullptr});
+        }
+    }
+    return parents;
+}
+
+std::unique_ptr<RTree::Node> RTree::InsertEntry(Node& node, Entry entry) {
+    if (node.leaf) {
+        node.entries.push_back(std::move(entry));
+    } else {
+        size_t best = 0;
+        double best_growth = std::numeric_limits<double>::infinity();
+        double best_area = std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < node.entries.size(); ++i) {
+            const double area = node.entries[i].box.Area();
+            const double growth = node.entries[i].box.Merge(entry.box).Area() - area;
+            if (growth < best_growth || (growth == best_growth && area < best_area)) {
+                best = i;
+                best_growth = growth;
+                best_area = area;
+            }
+        }
+
+        Entry& target = node.entries[best];
+        target.box = target.box.Merge(entry.box);
+        std::unique_ptr<Node> sibling = InsertEntry(*target.child, std::move(entry));
+        if (sibling) {
+            target.box = NodeBox(*target.child);
+            figure::Box box = NodeBox(*sibling);
+            node.entries.push_back({box, std::move(sibling), nullptr});
+        }
+    }
+
+    return node.entries.size() > MAX_ENTRIES ? Split(node) : nullptr;
+}
+
+std::unique_ptr<RTree::Node> RTree::Split(Node& node) {
+    figure::Box centers;
+    for (const Entry& entry : node.entries) {
+        figure::Point center = entry.box.Center();
+        centers = centers.Merge(figure::Box(center.x, center.y, center.x, center.y));
+    }
+
+    const bool by_x = centers.max_x - centers.min_x >= centers.max_y - centers.min_y;
+    std::sort(node.entries.begin(), node.entries.end(), [by_x](const Entry& a, const Entry& b) {
+        return by_x ? a.box.Center().x < b.box.Center().x : a.box.Center().y < b.box.Center().y;
+    });
+
+    auto sibling = std::make_unique<Node>();
+    sibling->leaf = node.leaf;
+    const size_t half = node.entries.size() / 2;
+    for (size_t i = half; i < node.entries.size(); ++i) {
+        sibling->entries.push_back(std::move(node.entries[i]));
+    }
+    node.entries.resize(half);
+
+    return sibling;
+}
+
+bool RTree::EraseEntry(Node& node, const figure::Figure* fig, const figure::Box& box,
+                       std::vector<Entry>& orphans) {
+    if (node.leaf) {
+        for (size_t i = 0; i < node.entries.size(); ++i) {
+            const figure::Box& stored = node.entries[i].box;
+            if (node.entries[i].fig == fig && stored.min_x == box.min_x && stored.min_y == box.min_y &&
+                stored.max_x == box.max_x && stored.max_y == box.max_y) {
+                node.entries.erase(node.entries.begin() + i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    for (size_t i = 0; i < node.entries.size(); ++i) {
+        Entry& entry = node.entries[i];
+        if (!entry.box.Overlaps(box) || !EraseEntry(*entry.child, fig, box, orphans)) {
+            continue;
+        }
+
+        if (entry.child->entries.size() < MIN_ENTRIES) {
+            Collect(*entry.child, orphans);
+            node.entries.erase(node.entries.begin() + i);
+        } else {
+            entry.box = NodeBox(*entry.child);
+        }
+        return true;
+    }
+    return false;
+}
+
+void RTree::Collect(Node& node, std::vector<Entry>& out) {
+    for (Entry& entry : node.entries) {
+        if (node.leaf) {
+            out.push_back(std::move(entry));
+        } else {
+            Collect(*entry.child, out);
+        }
+    }
+}
+
+void RTree::Search(const Node& node, const figure::Box& box, std::vector<const figure::Figure*>& out) {
+    for (const Entry& entry : node.entries) {
+        if (!entry.box.Overlaps(box)) {
+            continue;
+        }
+        if (node.leaf) {
+            out.push_back(entry.fig);
+        } else {
+            Search(*entry.child, box, out);
+        }
+    }
+}
+
+void RTree::Search(const Node& node, const figure::Point& point, std::vector<const figure::Figure*>& out) {
+    for (const Entry& entry : node.entries) {
+        if (!entry.box.Contains(point)) {
+            continue;
+        }
+        if (node.leaf) {
+            if (figure::Contains(*entry.fig, point)) {
+                out.push_back(entry.fig);
+            }
+        } else {
+            Search(*entry.child, point, out);
+        }
+    }
+}
+
+}
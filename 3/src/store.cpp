@@ -0,0 +1,449 @@
+#include "store.hpp"
+#include "exceptions.hpp"
+#include "kernels.hpp"
+#include "ranking.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace store {
+
+struct Mapping {
+    void* data;
+    size_t size;
+};
+
+Store::Store() {}
+
+Store::Store(const vector::Vector& vec) {
+    for (size_t i = 0; i < vec.Size(); ++i) {
+        const figure::Figure& fig = vec[i];
+
+        if (auto pent = dynamic_cast<const figure::Pentagon*>(&fig)) {
+            PushBack(*pent);
+        } else if (auto rh = dynamic_cast<const figure::Rhombus*>(&fig)) {
+            PushBack(*rh);
+        } else if (auto trap = dynamic_cast<const figure::Trapezoid*>(&fig)) {
+            PushBack(*trap);
+        } else {
+            throw std::invalid_argument("unsupported figure type");
+        }
+    }
+}
+
+template <int N, typename Figure>
+void Store::Append(Batch<N>& batch, const Figure& fig) {
+    Detach(batch);
+    for (int i = 0; i < N; ++i) {
+        figure::Point vertex = fig.GetVertex(i);
+        batch.xs[i].push_back(vertex.x);
+        batch.ys[i].push_back(vertex.y);
+    }
+}
+
+template <int N>
+void Store::Reserve(Batch<N>& batch, size_t count) {
+    Detach(batch);
+    for (int i = 0; i < N; ++i) {
+        batch.xs[i].reserve(count);
+        batch.ys[i].reserve(count);
+    }
+}
+
+template <int N>
+void Store::Clear(Batch<N>& batch) noexcept {
+    for (int i = 0; i < N; ++i) {
+        batch.xs[i].clear();
+        batch.ys[i].clear();
+    }
+    batch.is_mapped = false;
+    batch.mapped_size = 0;
+}
+
+template <int N>
+void Store::Detach(Batch<N>& batch) {
+    if (!batch.is_mapped) {
+        return;
+    }
+
+    for (int i = 0; i < N; ++i) {
+        batch.xs[i].assign(batch.mapped_xs[i], batch.mapped_xs[i] + batch.mapped_size);
+        batch.ys[i].assign(batch.mapped_ys[i], batch.mapped_ys[i] + batch.mapped_size);
+    }
+    batch.is_mapped = false;
+    batch.mapped_size = 0;
+}
+
+template <int N>
+void Store::Merge(Batch<N>& batch, const Batch<N>& other) {
+    Detach(batch);
+    for (int i = 0; i < N; ++i) {
+        batch.xs[i].insert(batch.xs[i].end(), other.X(i), other.X(i) + other.Size());
+        batch.ys[i].insert(batch.ys[i].end(), other.Y(i), other.Y(i) + other.Size());
+    }
+}
+
+template <int N>
+const double* Store::MapBatch(Batch<N>& batch, const double* data, size_t count) {
+    for (int i = 0; i < N; ++i) {
+        batch.mapped_xs[i] = data;
+        data += count;
+        batch.mapped_ys[i] = data;
+        data += count;
+    }
+    batch.mapped_size = count;
+    batch.is_mapped = true;
+    return data;
+}
+
+template <int N>
+void Store::WriteBatch(std::ostream& stream, const Batch<N>& batch) {
+    const std::streamsize bytes = static_cast<std::streamsize>(batch.Size() * sizeof(double));
+    for (int i = 0; i < N; ++i) {
+        stream.write(reinterpret_cast<const char*>(batch.X(i)), bytes);
+        stream.write(reinterpret_cast<const char*>(batch.Y(i)), bytes);
+    }
+}
+
+void Store::PushBack(const figure::Pentagon& pent) {
+    Append(pentagons_, pent);
+}
+
+void Store::PushBack(const figure::Rhombus& rh) {
+    Append(rhombi_, rh);
+}
+
+void Store::PushBack(const figure::Trapezoid& trap) {
+    Append(trapezoids_, trap);
+}
+
+void Store::Merge(const Store& other) {
+    if (this == &other) {
+        Store copy(other);
+        Merge(copy);
+        return;
+    }
+
+    Merge(pentagons_, other.pentagons_);
+    Merge(rhombi_, other.rhombi_);
+    Merge(trapezoids_, other.trapezoids_);
+}
+
+void Store::Reserve(size_t pentagons, size_t rhombi, size_t trapezoids) {
+    Reserve(pentagons_, pentagons);
+    Reserve(rhombi_, rhombi);
+    Reserve(trapezoids_, trapezoids);
+}
+
+void Store::Clear() noexcept {
+    Clear(pentagons_);
+    Clear(rhombi_);
+    Clear(trapezoids_);
+    mapping_.reset();
+}
+
+bool Store::IsEmpty() const noexcept {
+    return Size() == 0;
+}
+
+size_t Store::Size() const noexcept {
+    return PentagonCount() + RhombusCount() + TrapezoidCount();
+}
+
+size_t Store::PentagonCount() const noexcept {
+    return pentagons_.Size();
+}
+
+size_t Store::RhombusCount() const noexcept {
+    return rhombi_.Size();
+}
+
+size_t Store::TrapezoidCount() const noexcept {
+    return trapezoids_.Size();
+}
+
+template <int N>
+void Store::Areas(const Batch<N>& batch, size_t from, size_t count, double* out) {
+    const double* xs[N];
+    const double* ys[N];
+    for (int i = 0; i < N; ++i) {
+        xs[i] = batch.X(i) + from;
+        ys[i] = batch.Y(i) + from;
+    }
+
+    kernels::ShoelaceAreas<N>(xs, ys, count, out);
+}
+
+template <int N>
+double Store::SumAreas(const Batch<N>& batch) {
+    double areas[BLOCK];
+    double lanes[4] = {0, 0, 0, 0};
+
+    for (size_t from = 0; from < batch.Size(); from += BLOCK) {
+        const size_t count = std::min(BLOCK, batch.Size() - from);
+        Areas(batch, from, count, areas);
+
+        size_t j = 0;
+        for (; j + 4 <= count; j += 4) {
+            lanes[0] += areas[j];
+            lanes[1] += areas[j + 1];
+            lanes[2] += areas[j + 2];
+            lanes[3] += areas[j + 3];
+        }
+        for (; j < count; ++j) {
+            lanes[0] += areas[j];
+        }
+    }
+
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+template <int N>
+void Store::Centers(const Batch<N>& batch, figure::Point* out) {
+    const double* xs[N];
+    const double* ys[N];
+    for (int i = 0; i < N; ++i) {
+        xs[i] = batch.X(i);
+        ys[i] = batch.Y(i);
+    }
+
+    std::vector<double> cx(batch.Size()), cy(batch.Size());
+    kernels::VertexCenters<N>(xs, ys, batch.Size(), cx.data(), cy.data());
+
+    for (size_t j = 0; j < batch.Size(); ++j) {
+        out[j] = figure::Point(cx[j], cy[j]);
+    }
+}
+
+template <int N>
+void Store::Contains(const Batch<N>& batch, const double* points, size_t count, uint64_t* masks) {
+    double vx[N], vy[N];
+    for (size_t j = 0; j < batch.Size(); ++j) {
+        for (int i = 0; i < N; ++i) {
+            vx[i] = batch.X(i)[j];
+            vy[i] = batch.Y(i)[j];
+        }
+        kernels::ContainsMask<N>(vx, vy, points, count, masks);
+    }
+}
+
+template <int N>
+void Store::ContainsSorted(const Batch<N>& batch, const double* points, size_t count, uint64_t* masks) {
+    auto lower_bound_x = [points, count](double x) {
+        size_t lo = 0, hi = count;
+        while (lo < hi) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if (points[2 * mid] < x) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    };
+
+    double vx[N], vy[N];
+    for (size_t j = 0; j < batch.Size(); ++j) {
+        for (int i = 0; i < N; ++i) {
+            vx[i] = batch.X(i)[j];
+            vy[i] = batch.Y(i)[j];
+        }
+
+        const auto [min_x, max_x] = std::minmax_element(vx, vx + N);
+        const size_t begin = lower_bound_x(*min_x - figure::EPS) & ~size_t(63);
+        const size_t end = lower_bound_x(std::nextafter(*max_x + figure::EPS, HUGE_VAL));
+        if (begin < end) {
+            kernels::ContainsMask<N>(vx, vy, points + 2 * begin, end - begin, masks + begin / 64);
+        }
+    }
+}
+
+template <typename Shape, int N>
+Shape Store::Get(const Batch<N>& batch, size_t idx) {
+    Shape res;
+    for (int i = 0; i < N; ++i) {
+        res.SetVertex(i, figure::Point(batch.X(i)[idx], batch.Y(i)[idx]));
+    }
+    return res;
+}
+
+vector::Shape Store::At(size_t idx) const {
+    if (idx < PentagonCount()) {
+        return Get<figure::Pentagon>(pentagons_, idx);
+    }
+    idx -= PentagonCount();
+    if (idx < RhombusCount()) {
+        return Get<figure::Rhombus>(rhombi_, idx);
+    }
+    idx -= RhombusCount();
+    if (idx < TrapezoidCount()) {
+        return Get<figure::Trapezoid>(trapezoids_, idx);
+    }
+    throw std::out_of_range("index out of bounds");
+}
+
+double Store::TotalArea() const {
+    return SumAreas(pentagons_) + SumAreas(rhombi_) + SumAreas(trapezoids_);
+}
+
+std::vector<double> Store::Areas() const {
+    std::vector<double> res(Size());
+
+    double* out = res.data();
+    Areas(pentagons_, 0, PentagonCount(), out);
+    out += PentagonCount();
+    Areas(rhombi_, 0, RhombusCount(), out);
+    out += RhombusCount();
+    Areas(trapezoids_, 0, TrapezoidCount(), out);
+
+    return res;
+}
+
+std::vector<figure::Point> Store::Centers() const {
+    std::vector<figure::Point> res(Size());
+
+    figure::Point* out = res.data();
+    Centers(pentagons_, out);
+    out += PentagonCount();
+    Centers(rhombi_, out);
+    out += RhombusCount();
+    Centers(trapezoids_, out);
+
+    return res;
+}
+
+std::vector<size_t> Store::TopK(size_t k) const {
+    return ranking::TopK(Areas(), k);
+}
+
+std::vector<size_t> Store::SortByArea(size_t threads) const {
+    return ranking::SortedOrder(Areas(), threads);
+}
+
+double Store::AreaPercentile(double q) const {
+    return ranking::Percentile(Areas(), q);
+}
+
+std::vector<uint64_t> Store::Contains(const std::vector<figure::Point>& points) const {
+    std::vector<uint64_t> masks((points.size() + 63) / 64, 0);
+    if (Size() < PREFILTER_MIN_FIGURES) {
+        const double* coords = &points.data()->x;
+        Contains(pentagons_, coords, points.size(), masks.data());
+        Contains(rhombi_, coords, points.size(), masks.data());
+        Contains(trapezoids_, coords, points.size(), masks.data());
+        return masks;
+    }
+
+    std::vector<size_t> order(points.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return points[a].x < points[b].x; });
+
+    std::vector<double> sorted(2 * points.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        sorted[2 * i] = points[order[i]].x;
+        sorted[2 * i + 1] = points[order[i]].y;
+    }
+
+    std::vector<uint64_t> sorted_masks(masks.size(), 0);
+    ContainsSorted(pentagons_, sorted.data(), points.size(), sorted_masks.data());
+    ContainsSorted(rhombi_, sorted.data(), points.size(), sorted_masks.data());
+    ContainsSorted(trapezoids_, sorted.data(), points.size(), sorted_masks.data());
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        masks[order[i] / 64] |= ((sorted_masks[i / 64] >> (i % 64)) & 1) << (order[i] % 64);
+    }
+    return masks;
+}
+
+bool Store::IsMapped() const noexcept {
+    return pentagons_.is_mapped || rhombi_.is_mapped || trapezoids_.is_mapped;
+}
+
+void Store::WriteBinary(const std::string& path) const {
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        throw exceptions::StorageException("cannot open " + path);
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, FORMAT_MAGIC, sizeof(header.magic));
+    header.version = FORMAT_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.counts[0] = PentagonCount();
+    header.counts[1] = RhombusCount();
+    header.counts[2] = TrapezoidCount();
+
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    WriteBatch(stream, pentagons_);
+    WriteBatch(stream, rhombi_);
+    WriteBatch(stream, trapezoids_);
+
+    if (!stream) {
+        throw exceptions::StorageException("cannot write " + path);
+    }
+}
+
+Store Store::MapBinary(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw exceptions::StorageException("cannot open " + path);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw exceptions::StorageException("cannot stat " + path);
+    }
+
+    const size_t size = static_cast<size_t>(info.st_size);
+    if (size < sizeof(FileHeader)) {
+        close(fd);
+        throw exceptions::FormatException("truncated header in " + path);
+    }
+
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        throw exceptions::StorageException("cannot map " + path);
+    }
+    std::shared_ptr<const Mapping> mapping(new Mapping{data, size}, [](const Mapping* map) {
+        munmap(map->data, map->size);
+        delete map;
+    });
+
+    FileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, FORMAT_MAGIC, sizeof(header.magic)) != 0 || header.version != FORMAT_VERSION ||
+        header.byte_order != BYTE_ORDER_MARK) {
+        throw exceptions::FormatException("unsupported figure file " + path);
+    }
+
+    const size_t limit = size / sizeof(double);
+    const uint64_t* counts = header.counts;
+    if (counts[0] > limit || counts[1] > limit || counts[2] > limit ||
+        sizeof(FileHeader) + sizeof(double) * 2 *
+                                 (counts[0] * figure::PENTAGON_ANGLES + counts[1] * figure::RHOMBUS_ANGLES +
+                                  counts[2] * figure::TRAPEZOID_ANGLES) != size) {
+        throw exceptions::FormatException("size mismatch in " + path);
+    }
+
+    Store res;
+    res.mapping_ = mapping;
+    const double* cur = reinterpret_cast<const double*>(static_cast<const char*>(data) + sizeof(FileHeader));
+    cur = MapBatch(res.pentagons_, cur, counts[0]);
+    cur = MapBatch(res.rhombi_, cur, counts[1]);
+    MapBatch(res.trapezoids_, cur, counts[2]);
+
+    return res;
+}
+
+}
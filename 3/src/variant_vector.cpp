@@ -0,0 +1,142 @@
+#include "variant_vector.hpp"
+#include "ranking.hpp"
+
+#include <iostream>
+#include <stdexcept>
+
+namespace vector {
+
+VariantVector::VariantVector() {}
+
+VariantVector::VariantVector(std::initializer_list<Shape> init) : data_(init) {}
+
+Shape& VariantVector::operator[](size_t pos) {
+    if (pos >= data_.size()) {
+        throw std::out_of_range("index out of bounds");
+    }
+    return data_[pos];
+}
+
+const Shape& VariantVector::operator[](size_t pos) const {
+    if (pos >= data_.size()) {
+        throw std::out_of_range("index out of bounds");
+    }
+    return data_[pos];
+}
+
+Shape& VariantVector::Front() noexcept {
+    return data_.front();
+}
+
+Shape& VariantVector::Back() noexcept {
+    return data_.back();
+}
+
+const Shape* VariantVector::Data() const noexcept {
+    return data_.data();
+}
+
+bool VariantVector::IsEmpty() const noexcept {
+    return data_.empty();
+}
+
+size_t VariantVector::Size() const noexcept {
+    return data_.size();
+}
+
+size_t VariantVector::Capacity() const noexcept {
+    return data_.capacity();
+}
+
+void VariantVector::Reserve(size_t new_cap) {
+    data_.reserve(new_cap);
+}
+
+void VariantVector::Clear() noexcept {
+    data_.clear();
+}
+
+void VariantVector::Insert(size_t pos, const Shape& value) {
+    if (pos >= data_.size()) {
+        PushBack(value);
+        return;
+    }
+    data_.insert(data_.begin() + pos, value);
+}
+
+void VariantVector::Erase(size_t begin_pos, size_t end_pos) {
+    if (begin_pos >= end_pos || end_pos > data_.size()) return;
+
+    data_.erase(data_.begin() + begin_pos, data_.begin() + end_pos);
+}
+
+void VariantVector::Erase(size_t pos) {
+    Erase(pos, pos + 1);
+}
+
+void VariantVector::PushBack(const Shape& value) {
+    data_.push_back(value);
+}
+
+void VariantVector::PopBack() {
+    if (!data_.empty()) data_.pop_back();
+}
+
+double VariantVector::TotalArea() const {
+    double total = 0;
+    for (const Shape& shape : data_) {
+        total += Area(shape);
+    }
+    return total;
+}
+
+std::vector<double> VariantVector::Areas() const {
+    std::vector<double> res;
+    res.reserve(data_.size());
+    for (const Shape& shape : data_) {
+        res.push_back(Area(shape));
+    }
+    return res;
+}
+
+std::vector<size_t> VariantVector::TopK(size_t k) const {
+    return ranking::TopK(Areas(), k);
+}
+
+std::vector<size_t> VariantVector::SortByArea(size_t threads) const {
+    return ranking::SortedOrder(Areas(), threads);
+}
+
+double VariantVector::AreaPercentile(double q) const {
+    return ranking::Percentile(Areas(), q);
+}
+
+std::vector<uint64_t> VariantVector::Contains(const std::vector<figure::Point>& points) const {
+    std::vector<uint64_t> masks((points.size() + 63) / 64, 0);
+    for (const Shape& shape : data_) {
+        std::visit([&](const auto& fig) { fig.Contains(points.data(), points.size(), masks.data()); }, shape);
+    }
+    return masks;
+}
+
+void VariantVector::SeparateCenter() const {
+    for (size_t i = 0; i < data_.size(); ++i) {
+        std::cout << "Figure center " << (i + 1) << ": " << Center(data_[i]) << "\n";
+    }
+}
+
+void VariantVector::SeparateArea() const {
+    for (size_t i = 0; i < data_.size(); ++i) {
+        std::cout << "Figure area " << (i + 1) << ": " << Area(data_[i]) << "\n";
+    }
+}
+
+figure::Point Center(const Shape& shape) {
+    return std::visit([](const auto& fig) { return fig.Center(); }, shape);
+}
+
+double Area(const Shape& shape) {
+    return std::visit([](const auto& fig) { return fig.Area(); }, shape);
+}
+
+}
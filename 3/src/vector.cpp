@@ -1,7 +1,18 @@
 #include "vector.hpp"
 #include "figure.hpp"
+#include "pentagon.hpp"
+#include "ranking.hpp"
+#include "rhombus.hpp"
+#include "trapezoid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <future>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace vector {
 
@@ -12,9 +23,35 @@ Vector::Vector(std::initializer_list<figure::Figure*> init)
     size_t idx = 0;
     for (auto fig : init) {
         data_[idx++] = fig;
+        aggregates_.Add(fig);
     }
 }
 
+Vector::Vector(Vector&& other) noexcept
+    : size_(std::exchange(other.size_, 0)),
+      capacity_(std::exchange(other.capacity_, 0)),
+      data_(std::exchange(other.data_, nullptr)),
+      arena_(std::move(other.arena_)),
+      aggregates_(other.aggregates_) {
+    other.aggregates_.Reset();
+}
+
+Vector& Vector::operator=(Vector&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+
+    delete[] data_;
+    size_ = std::exchange(other.size_, 0);
+    capacity_ = std::exchange(other.capacity_, 0);
+    data_ = std::exchange(other.data_, nullptr);
+    arena_ = std::move(other.arena_);
+    aggregates_ = other.aggregates_;
+    other.aggregates_.Reset();
+
+    return *this;
+}
+
 figure::Figure& Vector::operator[](size_t pos) {
     if (pos >= size_) {
         throw std::out_of_range("index out of bounds");
@@ -45,6 +82,13 @@ bool Vector::IsEmpty() const noexcept {
     return size_ == 0;
 }
 
+bool Vector::IsOwned(size_t pos) const {
+    if (pos >= size_) {
+        throw std::out_of_range("index out of bounds");
+    }
+    return data_[pos] != nullptr && arena_.Owns(data_[pos]);
+}
+
 size_t Vector::Size() const noexcept {
     return size_;
 }
@@ -57,8 +101,8 @@ void Vector::Reserve(size_t new_cap) {
     if (new_cap <= capacity_) return;
     
     figure::Figure** new_data = new figure::Figure*[new_cap];
-    for (size_t i = 0; i < size_; ++i) {
-        new_data[i] = data_[i];
+    if (size_ > 0) {
+        std::memcpy(new_data, data_, size_ * sizeof(figure::Figure*));
     }
     delete[] data_;
     data_ = new_data;
@@ -70,6 +114,8 @@ void Vector::Clear() noexcept {
     data_ = nullptr;
     size_ = 0;
     capacity_ = 0;
+    arena_.Release();
+    aggregates_.Reset();
 }
 
 void Vector::Insert(size_t pos, figure::Figure* value) {
@@ -82,20 +128,21 @@ void Vector::Insert(size_t pos, figure::Figure* value) {
         return;
     }
     
-    for (size_t i = size_; i > pos; --i) {
-        data_[i] = data_[i - 1];
-    }
+    std::memmove(data_ + pos + 1, data_ + pos, (size_ - pos) * sizeof(figure::Figure*));
     data_[pos] = value;
     ++size_;
+    aggregates_.Add(value);
 }
 
 void Vector::Erase(size_t begin_pos, size_t end_pos) {
     if (begin_pos >= end_pos || end_pos > size_) return;
     
-    size_t shift = end_pos - begin_pos;
-    for (size_t i = end_pos; i < size_; ++i) {
-        data_[begin_pos + i - end_pos] = data_[i];
+    for (size_t i = begin_pos; i < end_pos; ++i) {
+        Drop(data_[i]);
     }
+
+    size_t shift = end_pos - begin_pos;
+    std::memmove(data_ + begin_pos, data_ + end_pos, (size_ - end_pos) * sizeof(figure::Figure*));
     size_ -= shift;
 }
 
@@ -103,15 +150,42 @@ void Vector::Erase(size_t pos) {
     Erase(pos, pos + 1);
 }
 
+void Vector::InsertRange(size_t pos, figure::Figure* const* values, size_t count) {
+    if (count == 0) return;
+
+    if (size_ + count > capacity_) {
+        Reserve(std::max(size_ + count, capacity_ * 2));
+    }
+
+    pos = std::min(pos, size_);
+    std::memmove(data_ + pos + count, data_ + pos, (size_ - pos) * sizeof(figure::Figure*));
+    std::memcpy(data_ + pos, values, count * sizeof(figure::Figure*));
+    size_ += count;
+    for (size_t i = 0; i < count; ++i) {
+        aggregates_.Add(values[i]);
+    }
+}
+
 void Vector::PushBack(figure::Figure* value) {
     if (size_ == capacity_) {
         Reserve(capacity_ == 0 ? 1 : capacity_ * 2);
     }
     data_[size_++] = value;
+    aggregates_.Add(value);
 }
 
 void Vector::PopBack() {
-    if (size_ > 0) --size_;
+    if (size_ > 0) {
+        Drop(data_[--size_]);
+    }
+}
+
+void Vector::Drop(figure::Figure* value) noexcept {
+    aggregates_.Remove(value);
+    if (value != nullptr && !arena_.IsEmpty() && arena_.Owns(value)) {
+        value->~Figure();
+        arena_.Recycle(value);
+    }
 }
 
 double Vector::TotalArea() {
@@ -122,6 +196,68 @@ double Vector::TotalArea() {
     return total;
 }
 
+double Vector::TotalArea(size_t threads) const {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    const size_t blocks = (size_ + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+    std::vector<double> partial(blocks);
+    RunChunks(blocks, threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            partial[i] = SumAreas(i * REDUCE_BLOCK, std::min(size_, (i + 1) * REDUCE_BLOCK));
+        }
+    });
+
+    double sum = 0, comp = 0;
+    for (double val : partial) {
+        NeumaierAdd(sum, comp, val);
+    }
+    return sum + comp;
+}
+
+std::vector<double> Vector::Areas(size_t threads) const {
+    std::vector<double> res(size_);
+    RunChunks(size_, threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads,
+              [&](size_t begin, size_t end) {
+                  for (size_t i = begin; i < end; ++i) {
+                      res[i] = data_[i]->Area();
+                  }
+              });
+    return res;
+}
+std::vector<size_t> Vector::TopK(size_t k) const {
+    return ranking::TopK(Areas(), k);
+}
+
+std::vector<size_t> Vector::SortByArea(size_t threads) const {
+    return ranking::SortedOrder(Areas(threads), threads);
+}
+
+double Vector::AreaPercentile(double q) const {
+    return ranking::Percentile(Areas(), q);
+}
+
+Summary Vector::Summarize() const {
+    return aggregates_.Get(data_, size_);
+}
+
+void Vector::EnableSummary() noexcept {
+    aggregates_.Enable();
+}
+
+void Vector::InvalidateSummary() noexcept {
+    aggregates_.Invalidate();
+}
+
+std::vector<uint64_t> Vector::Contains(const std::vector<figure::Point>& points) const {
+    std::vector<uint64_t> masks((points.size() + 63) / 64, 0);
+    for (size_t i = 0; i < size_; ++i) {
+        data_[i]->Contains(points.data(), points.size(), masks.data());
+    }
+    return masks;
+}
+
 void Vector::SeparateCenter() {
     for (size_t i = 0; i < size_; ++i) {
         std::cout << "Figure center " << (i + 1) << ": " << data_[i]->Center() << "\n";
@@ -138,10 +274,179 @@ Vector::~Vector() {
     delete[] data_;
 }
 
+double Vector::SumAreas(size_t begin, size_t end) const {
+    double sum = 0, comp = 0;
+    for (size_t i = begin; i < end; ++i) {
+        NeumaierAdd(sum, comp, data_[i]->Area());
+    }
+    return sum + comp;
+}
+
+void Vector::NeumaierAdd(double& sum, double& comp, double val) noexcept {
+    double total = sum + val;
+    if (std::fabs(sum) >= std::fabs(val)) {
+        comp += (sum - total) + val;
+    } else {
+        comp += (val - total) + sum;
+    }
+    sum = total;
+}
+
+void Vector::RunChunks(size_t count, size_t threads, const std::function<void(size_t, size_t)>& func) {
+    if (threads <= 1 || count < threads) {
+        func(0, count);
+        return;
+    }
+
+    std::vector<std::future<void>> tasks;
+    const size_t step = (count + threads - 1) / threads;
+    for (size_t begin = step; begin < count; begin += step) {
+        tasks.push_back(std::async(std::launch::async, func, begin, std::min(begin + step, count)));
+    }
+    func(0, std::min(step, count));
+
+    for (auto& task : tasks) {
+        task.get();
+    }
+}
+
+void Vector::Aggregates::Include(Summary& summary, double& comp, const figure::Figure* fig) {
+    if (fig == nullptr) {
+        return;
+    }
+
+    const double area = fig->Area();
+    summary.pentagons += dynamic_cast<const figure::Pentagon*>(fig) != nullptr;
+    summary.rhombi += dynamic_cast<const figure::Rhombus*>(fig) != nullptr;
+    summary.trapezoids += dynamic_cast<const figure::Trapezoid*>(fig) != nullptr;
+    summary.min_area = summary.count == 0 ? area : std::min(summary.min_area, area);
+    summary.max_area = summary.count == 0 ? area : std::max(summary.max_area, area);
+    summary.bounds = summary.bounds.Merge(figure::Bounds(*fig));
+    NeumaierAdd(summary.total_area, comp, area);
+    ++summary.count;
+}
+
+Summary Vector::Aggregates::Scan(figure::Figure* const* data, size_t size) {
+    Summary res;
+    double comp = 0;
+    for (size_t i = 0; i < size; ++i) {
+        Include(res, comp, data[i]);
+    }
+    res.total_area += comp;
+    return res;
+}
+
+Vector::Aggregates::Aggregates(const Aggregates& other) noexcept {
+    *this = other;
+}
+
+Vector::Aggregates& Vector::Aggregates::operator=([[maybe_unused]] const Aggregates& other) noexcept {
+#ifdef VECTOR_AGGREGATES
+    summary_ = other.summary_;
+    area_comp_ = other.area_comp_;
+    epoch_ = other.epoch_;
+    is_stale_ = other.is_stale_;
+    is_enabled_ = other.is_enabled_;
+#endif
+    return *this;
+}
+
+void Vector::Aggregates::Add([[maybe_unused]] const figure::Figure* fig) {
+#ifdef VECTOR_AGGREGATES
+    if (!is_enabled_ || is_stale_) {
+        return;
+    }
+    Include(summary_, area_comp_, fig);
+#endif
+}
+
+void Vector::Aggregates::Remove([[maybe_unused]] const figure::Figure* fig) {
+#ifdef VECTOR_AGGREGATES
+    if (!is_enabled_ || is_stale_ || fig == nullptr) {
+        return;
+    }
+    if (fig->Version() > epoch_) {
+        is_stale_ = true;
+        return;
+    }
+    if (summary_.count == 1) {
+        Reset();
+        return;
+    }
+
+    const double area = fig->Area();
+    const figure::Box box = figure::Bounds(*fig);
+    summary_.pentagons -= dynamic_cast<const figure::Pentagon*>(fig) != nullptr;
+    summary_.rhombi -= dynamic_cast<const figure::Rhombus*>(fig) != nullptr;
+    summary_.trapezoids -= dynamic_cast<const figure::Trapezoid*>(fig) != nullptr;
+    NeumaierAdd(summary_.total_area, area_comp_, -area);
+    --summary_.count;
+
+    if (area <= summary_.min_area || area >= summary_.max_area || box.min_x <= summary_.bounds.min_x ||
+        box.min_y <= summary_.bounds.min_y || box.max_x >= summary_.bounds.max_x ||
+        box.max_y >= summary_.bounds.max_y) {
+        is_stale_ = true;
+    }
+#endif
+}
+
+void Vector::Aggregates::Enable() noexcept {
+#ifdef VECTOR_AGGREGATES
+    if (!is_enabled_) {
+        is_enabled_ = true;
+        is_stale_ = true;
+    }
+#endif
+}
+
+void Vector::Aggregates::Reset() noexcept {
+#ifdef VECTOR_AGGREGATES
+    summary_ = Summary();
+    area_comp_ = 0;
+    epoch_ = figure::EditEpoch();
+    is_stale_ = false;
+#endif
+}
+
+void Vector::Aggregates::Invalidate() noexcept {
+#ifdef VECTOR_AGGREGATES
+    is_stale_ = true;
+#endif
+}
+
+Summary Vector::Aggregates::Get(figure::Figure* const* data, size_t size) const {
+#ifdef VECTOR_AGGREGATES
+    if (!is_enabled_) {
+        return Scan(data, size);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t epoch = figure::EditEpoch();
+    if (!is_stale_ && epoch != epoch_) {
+        is_stale_ = std::any_of(data, data + size, [this](const figure::Figure* fig) {
+            return fig != nullptr && fig->Version() > epoch_;
+        });
+    }
+    if (is_stale_) {
+        summary_ = Scan(data, size);
+        area_comp_ = 0;
+        is_stale_ = false;
+    }
+    epoch_ = epoch;
+
+    Summary res = summary_;
+    res.total_area += area_comp_;
+    return res;
+#else
+    return Scan(data, size);
+#endif
+}
+
 void swap(Vector& v1, Vector& v2) noexcept {
     std::swap(v1.size_, v2.size_);
     std::swap(v1.capacity_, v2.capacity_);
     std::swap(v1.data_, v2.data_);
+    std::swap(v1.arena_, v2.arena_);
+    std::swap(v1.aggregates_, v2.aggregates_);
 }
 
 }
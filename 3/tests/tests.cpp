@@ -4,6 +4,28 @@
 #include "rhombus.hpp"
 #include "pentagon.hpp"
 #include "vector.hpp"
+#include "store.hpp"
+#include "kernels.hpp"
+#include "variant_vector.hpp"
+#include "arena.hpp"
+#include "rtree.hpp"
+#include "exceptions.hpp"
+#include "parser.hpp"
+#include "polygon.hpp"
+#include "ranking.hpp"
+#include "collision.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 TEST(PointTest, DefaultConstructor) {
     figure::Point p;
@@ -139,6 +161,9 @@ TEST(VectorTest, InitializerListConstructor) {
     vector::Vector v = {t1, t2};
     EXPECT_EQ(v.Size(), 2);
     EXPECT_FALSE(v.IsEmpty());
+
+    delete t1;
+    delete t2;
 }
 
 TEST(VectorTest, PushBackAndSize) {
@@ -148,6 +173,8 @@ TEST(VectorTest, PushBackAndSize) {
     v.PushBack(t);
     EXPECT_EQ(v.Size(), 1);
     EXPECT_FALSE(v.IsEmpty());
+
+    delete t;
 }
 
 TEST(VectorTest, TotalAreaCalculation) {
@@ -160,6 +187,9 @@ TEST(VectorTest, TotalAreaCalculation) {
     
     double totalArea = v.TotalArea();
     EXPECT_NEAR(totalArea, t->Area() + r->Area(), 1e-9);
+
+    delete t;
+    delete r;
 }
 
 TEST(VectorTest, ElementAccess) {
@@ -168,6 +198,8 @@ TEST(VectorTest, ElementAccess) {
     
     EXPECT_NO_THROW(v[0]);
     EXPECT_THROW(v[1], std::out_of_range);
+
+    delete t;
 }
 
 TEST(VectorTest, FrontAndBack) {
@@ -178,6 +210,9 @@ TEST(VectorTest, FrontAndBack) {
     
     EXPECT_EQ(&v.Front(), &v[0]);
     EXPECT_EQ(&v.Back(), &v[1]);
+
+    delete t1;
+    delete t2;
 }
 
 TEST(VectorTest, InsertAndErase) {
@@ -194,6 +229,9 @@ TEST(VectorTest, InsertAndErase) {
     v.Erase(0);
     EXPECT_EQ(v.Size(), 1);
     EXPECT_EQ(&v[0], t1);
+
+    delete t1;
+    delete t2;
 }
 
 TEST(VectorTest, ReserveAndCapacity) {
@@ -214,6 +252,8 @@ TEST(VectorTest, Clear) {
     v.Clear();
     EXPECT_EQ(v.Size(), 0);
     EXPECT_TRUE(v.IsEmpty());
+
+    delete t;
 }
 
 TEST(VectorTest, PopBack) {
@@ -225,6 +265,8 @@ TEST(VectorTest, PopBack) {
     
     v.PopBack();
     EXPECT_EQ(v.Size(), 0);
+
+    delete t;
 }
 
 
@@ -261,6 +303,864 @@ TEST(ValidationTest, TrapezoidValidation) {
     EXPECT_TRUE(valid_trapezoid.IsValid());
 }
 
+TEST(StoreTest, MatchesVector) {
+    figure::Trapezoid t({0,0}, {4,0}, {3,3}, {1,3});
+    figure::Rhombus r({0,0}, {2,1}, {0,2}, {-2,1});
+    figure::Pentagon p;
+
+    vector::Vector v = {&t, &r, &p};
+    store::Store s(v);
+
+    EXPECT_EQ(s.Size(), 3);
+    EXPECT_EQ(s.PentagonCount(), 1);
+    EXPECT_EQ(s.RhombusCount(), 1);
+    EXPECT_EQ(s.TrapezoidCount(), 1);
+    EXPECT_NEAR(s.TotalArea(), v.TotalArea(), 1e-9);
+
+    std::vector<double> areas = s.Areas();
+    std::vector<figure::Point> centers = s.Centers();
+    ASSERT_EQ(areas.size(), 3);
+    EXPECT_DOUBLE_EQ(areas[0], p.Area());
+    EXPECT_DOUBLE_EQ(areas[1], r.Area());
+    EXPECT_DOUBLE_EQ(areas[2], t.Area());
+    EXPECT_EQ(centers[0], p.Center());
+    EXPECT_EQ(centers[1], r.Center());
+    EXPECT_EQ(centers[2], t.Center());
+
+    s.Clear();
+    EXPECT_TRUE(s.IsEmpty());
+    EXPECT_DOUBLE_EQ(s.TotalArea(), 0.0);
+}
+
+TEST(StoreTest, ManyFigures) {
+    store::Store s;
+    double expected = 0;
+    for (int i = 0; i < 1000; ++i) {
+        figure::Rhombus r({0.0 + i, 0}, {2.0 + i, 1}, {0.0 + i, 2}, {-2.0 + i, 1});
+        figure::Pentagon p;
+        s.PushBack(r);
+        s.PushBack(p);
+        expected += r.Area() + p.Area();
+    }
+
+    EXPECT_EQ(s.Size(), 2000);
+    EXPECT_NEAR(s.TotalArea(), expected, 1e-6);
+}
+
+TEST(KernelsTest, ShoelaceMatchesScalarArea) {
+    const size_t count = 1003;
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> coord(-100.0, 100.0);
+
+    std::vector<double> xs[5], ys[5];
+    std::vector<figure::Pentagon> pentagons;
+    for (size_t j = 0; j < count; ++j) {
+        figure::Point pts[5];
+        for (int i = 0; i < 5; ++i) {
+            pts[i] = figure::Point(coord(gen), coord(gen));
+            xs[i].push_back(pts[i].x);
+            ys[i].push_back(pts[i].y);
+        }
+        pentagons.emplace_back(pts[0], pts[1], pts[2], pts[3], pts[4]);
+    }
+
+    const double* xp[5];
+    const double* yp[5];
+    for (int i = 0; i < 5; ++i) {
+        xp[i] = xs[i].data();
+        yp[i] = ys[i].data();
+    }
+
+    std::vector<double> areas(count), cx(count), cy(count);
+    kernels::ShoelaceAreas<5>(xp, yp, count, areas.data());
+    kernels::VertexCenters<5>(xp, yp, count, cx.data(), cy.data());
+    for (size_t j = 0; j < count; ++j) {
+        EXPECT_EQ(areas[j], pentagons[j].Area());
+        EXPECT_EQ(cx[j], pentagons[j].Center().x);
+        EXPECT_EQ(cy[j], pentagons[j].Center().y);
+    }
+}
+
+TEST(TrapezoidTest, SlantedAreaCalculation) {
+    figure::Trapezoid t({0,0}, {3,3}, {1,5}, {-1,3});
+    EXPECT_NEAR(t.Area(), 10.0, 1e-9);
+}
+
+TEST(VectorTest, ParallelTotalAreaIsDeterministic) {
+    std::vector<figure::Rhombus> figures;
+    for (int i = 0; i < 50000; ++i) {
+        const double scale = 1.0 + (i % 97) * 1e-3 + (i % 13) * 1e5;
+        figures.emplace_back(figure::Point(0, 0), figure::Point(2 * scale, scale),
+                             figure::Point(0, 2 * scale), figure::Point(-2 * scale, scale));
+    }
+
+    vector::Vector v;
+    for (auto& fig : figures) {
+        v.PushBack(&fig);
+    }
+
+    const double single = v.TotalArea(1);
+    EXPECT_EQ(single, v.TotalArea(2));
+    EXPECT_EQ(single, v.TotalArea(3));
+    EXPECT_EQ(single, v.TotalArea(8));
+    EXPECT_EQ(single, v.TotalArea(0));
+    EXPECT_NEAR(single, v.TotalArea(), single * 1e-12);
+}
+
+TEST(VectorTest, ConcurrentReadsShareCache) {
+    figure::Trapezoid shared({0,0}, {4,0}, {3,3}, {1,3});
+    figure::Rhombus other({0,0}, {2,1}, {0,2}, {-2,1});
+
+    vector::Vector v;
+    for (int i = 0; i < 4096; ++i) {
+        v.PushBack(i % 3 == 0 ? static_cast<figure::Figure*>(&other) : &shared);
+    }
+    std::vector<std::thread> readers;
+    std::vector<double> totals(4);
+    for (size_t t = 0; t < totals.size(); ++t) {
+        readers.emplace_back([&v, &totals, t] { totals[t] = v.TotalArea(4); });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    const double expected = v.TotalArea(1);
+    for (double total : totals) {
+        EXPECT_EQ(total, expected);
+    }
+    EXPECT_DOUBLE_EQ(shared.Area(), 9.0);
+    figure::Trapezoid fresh = shared;
+    fresh.SetVertex(0, fresh.GetVertex(0));
+    EXPECT_EQ(shared.Center(), fresh.Center());
+}
+
+TEST(VariantVectorTest, MatchesVector) {
+    figure::Trapezoid t({0,0}, {4,0}, {3,3}, {1,3});
+    figure::Rhombus r({0,0}, {2,1}, {0,2}, {-2,1});
+    figure::Pentagon p;
+
+    vector::Vector v = {&t, &r, &p};
+    vector::VariantVector vv = {t, r, p};
+
+    EXPECT_EQ(vv.Size(), 3);
+    EXPECT_DOUBLE_EQ(vv.TotalArea(), v.TotalArea());
+    EXPECT_EQ(vector::Center(vv[1]), r.Center());
+    EXPECT_TRUE(std::holds_alternative<figure::Pentagon>(vv.Back()));
+
+    vv.Insert(0, p);
+    vv.Erase(1, 3);
+    EXPECT_EQ(vv.Size(), 2);
+    EXPECT_DOUBLE_EQ(vector::Area(vv.Front()), p.Area());
+    EXPECT_THROW(vv[2], std::out_of_range);
+
+    vv.PopBack();
+    vv.Clear();
+    EXPECT_TRUE(vv.IsEmpty());
+}
+
+TEST(ArenaTest, DestroysObjectsOnRelease) {
+    struct Counted {
+        int* counter;
+        explicit Counted(int* c) : counter(c) {}
+        ~Counted() { ++*counter; }
+    };
+
+    int destroyed = 0;
+    arena::Arena a;
+    for (int i = 0; i < 10000; ++i) {
+        a.Make<Counted>(&destroyed);
+    }
+    auto* big = a.Make<std::array<double, 20000>>();
+    big->fill(1.0);
+    auto* aligned = a.Make<std::max_align_t>();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % alignof(std::max_align_t), 0);
+    EXPECT_GT(a.BlockCount(), 1);
+
+    a.Release();
+    EXPECT_EQ(destroyed, 10000);
+    EXPECT_TRUE(a.IsEmpty());
+    EXPECT_EQ(a.BlockCount(), 0);
+}
+
+TEST(VectorTest, EmplaceOwnsFigures) {
+    vector::Vector v;
+    figure::Trapezoid& t = v.Emplace<figure::Trapezoid>(figure::Point{0,0}, figure::Point{4,0},
+                                                        figure::Point{3,3}, figure::Point{1,3});
+    v.Emplace<figure::Rhombus>(figure::Point{0,0}, figure::Point{2,1}, figure::Point{0,2}, figure::Point{-2,1});
+    for (int i = 0; i < 5000; ++i) {
+        v.Emplace<figure::Pentagon>();
+    }
+
+    EXPECT_EQ(v.Size(), 5002);
+    EXPECT_EQ(&v[0], &t);
+    EXPECT_NEAR(v[1].Area(), 4.0, 1e-9);
+
+    vector::Vector moved(std::move(v));
+    EXPECT_TRUE(v.IsEmpty());
+    EXPECT_EQ(&moved[0], &t);
+    v = std::move(moved);
+    EXPECT_TRUE(moved.IsEmpty());
+    EXPECT_EQ(v.Size(), 5002);
+    EXPECT_NEAR(v[0].Area(), 9.0, 1e-9);
+
+    v.Clear();
+    EXPECT_TRUE(v.IsEmpty());
+    v.Emplace<figure::Pentagon>();
+    EXPECT_EQ(v.Size(), 1);
+
+    figure::Rhombus outside({0,0}, {2,1}, {0,2}, {-2,1});
+    v.PushBack(&outside);
+    EXPECT_TRUE(v.IsOwned(0));
+    EXPECT_FALSE(v.IsOwned(1));
+    EXPECT_THROW(v.IsOwned(2), std::out_of_range);
+
+    figure::Pentagon* first = &v.Emplace<figure::Pentagon>();
+    v.PopBack();
+    EXPECT_EQ(&v.Emplace<figure::Pentagon>(), first);
+    v.Erase(1);
+    EXPECT_EQ(v.Size(), 2);
+    EXPECT_NEAR(outside.Area(), 4.0, 1e-9);
+
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 1000; ++i) {
+            v.Emplace<figure::Pentagon>();
+        }
+        v.EraseIf([](const figure::Figure& fig) { return fig.VertexCount() == figure::PENTAGON_ANGLES; });
+        ASSERT_EQ(v.Size(), 0);
+    }
+}
+
+TEST(ArenaTest, RecyclesSlots) {
+    arena::Arena a;
+    int outside = 0;
+    EXPECT_FALSE(a.Owns(&outside));
+
+    using Small = std::array<double, 4>;
+    using Large = std::array<double, 8>;
+    Small* first = a.MakeRecyclable<Small>();
+    Large* second = a.MakeRecyclable<Large>();
+    EXPECT_TRUE(a.Owns(first));
+    EXPECT_TRUE(a.Owns(second));
+    EXPECT_FALSE(a.Owns(&outside));
+
+    a.Recycle(first);
+    EXPECT_NE(static_cast<void*>(a.MakeRecyclable<Large>()), static_cast<void*>(first));
+    EXPECT_EQ(a.MakeRecyclable<Small>(), first);
+
+    for (int i = 0; i < 100000; ++i) {
+        a.Recycle(a.MakeRecyclable<Small>());
+    }
+    EXPECT_EQ(a.BlockCount(), 1);
+}
+
+TEST(VectorTest, EraseIfAndInsertRange) {
+    vector::Vector v;
+    std::vector<figure::Rhombus> figures;
+    for (int i = 0; i < 10; ++i) {
+        figures.emplace_back(figure::Point{0, 0}, figure::Point{2.0 + i, 1}, figure::Point{0, 2},
+                             figure::Point{-2.0 - i, 1});
+    }
+    for (auto& fig : figures) {
+        v.PushBack(&fig);
+    }
+
+    size_t removed = v.EraseIf([](const figure::Figure& fig) { return static_cast<int>(fig.Area()) % 4 != 0; });
+    EXPECT_EQ(removed, 5);
+    ASSERT_EQ(v.Size(), 5);
+    for (size_t i = 0; i < v.Size(); ++i) {
+        EXPECT_EQ(&v[i], &figures[2 * i]);
+    }
+
+    v.PushBack(nullptr);
+    EXPECT_EQ(v.EraseIf([](const figure::Figure&) { return true; }), 5);
+    ASSERT_EQ(v.Size(), 1);
+    EXPECT_EQ(v.Data()[0], nullptr);
+    v.Clear();
+    for (size_t i = 0; i < figures.size(); i += 2) {
+        v.PushBack(&figures[i]);
+    }
+
+    size_t calls = 0;
+    EXPECT_THROW(v.EraseIf([&calls](const figure::Figure&) {
+        if (++calls == 3) {
+            throw std::runtime_error("pred");
+        }
+        return calls == 1;
+    }), std::runtime_error);
+    ASSERT_EQ(v.Size(), 4);
+    for (size_t i = 0; i < v.Size(); ++i) {
+        EXPECT_EQ(&v[i], &figures[2 * i + 2]);
+    }
+    v.Clear();
+    for (size_t i = 0; i < figures.size(); i += 2) {
+        v.PushBack(&figures[i]);
+    }
+
+    figure::Figure* extra[] = {&figures[1], &figures[3]};
+    v.InsertRange(1, extra, 2);
+    ASSERT_EQ(v.Size(), 7);
+    EXPECT_EQ(&v[0], &figures[0]);
+    EXPECT_EQ(&v[1], &figures[1]);
+    EXPECT_EQ(&v[2], &figures[3]);
+    EXPECT_EQ(&v[3], &figures[2]);
+
+    v.InsertRange(100, extra, 1);
+    EXPECT_EQ(&v.Back(), &figures[1]);
+    v.Erase(1, 3);
+    EXPECT_EQ(v.Size(), 6);
+    EXPECT_EQ(&v[1], &figures[2]);
+}
+
+TEST(VectorTest, SummaryTracksUpdates) {
+    figure::Pentagon pent;
+    figure::Rhombus rh({0,0}, {2,1}, {0,2}, {-2,1});
+    figure::Trapezoid trap({0,0}, {4,0}, {3,3}, {1,3});
+    figure::Rhombus far({10,10}, {11,11}, {10,12}, {9,11});
+
+    vector::Vector v;
+    EXPECT_EQ(v.Summarize().count, 0);
+    v.EnableSummary();
+    EXPECT_EQ(v.Summarize().count, 0);
+
+    v.PushBack(&rh);
+    v.PushBack(&trap);
+    v.Insert(0, &pent);
+    figure::Figure* extra[] = {&far};
+    v.InsertRange(1, extra, 1);
+
+    vector::Summary sum = v.Summarize();
+    EXPECT_EQ(sum.count, 4);
+    EXPECT_EQ(sum.pentagons, 1);
+    EXPECT_EQ(sum.rhombi, 2);
+    EXPECT_EQ(sum.trapezoids, 1);
+    EXPECT_NEAR(sum.total_area, pent.Area() + 4.0 + 9.0 + 2.0, 1e-9);
+    EXPECT_DOUBLE_EQ(sum.min_area, 2.0);
+    EXPECT_DOUBLE_EQ(sum.max_area, 9.0);
+    EXPECT_DOUBLE_EQ(sum.bounds.max_y, 12.0);
+
+    v.Erase(1);
+    v.PopBack();
+    sum = v.Summarize();
+    EXPECT_EQ(sum.count, 2);
+    EXPECT_EQ(sum.trapezoids, 0);
+    EXPECT_NEAR(sum.total_area, pent.Area() + 4.0, 1e-9);
+    EXPECT_DOUBLE_EQ(sum.min_area, pent.Area());
+    EXPECT_DOUBLE_EQ(sum.max_area, 4.0);
+    EXPECT_DOUBLE_EQ(sum.bounds.max_y, 2.0);
+
+    v.PushBack(nullptr);
+    EXPECT_EQ(v.Summarize().count, 2);
+    v.PopBack();
+
+    rh.SetVertex(2, {0, 4});
+    EXPECT_DOUBLE_EQ(v.Summarize().max_area, 8.0);
+
+    auto& made = v.Emplace<figure::Rhombus>(figure::Point(0, 0), figure::Point(1, 1), figure::Point(0, 2),
+                                             figure::Point(-1, 1));
+    EXPECT_DOUBLE_EQ(v.Summarize().max_area, 8.0);
+    made.SetVertex(2, {0, 20});
+    EXPECT_DOUBLE_EQ(v.Summarize().max_area, 20.0);
+
+    v.EraseIf([](const figure::Figure& fig) { return fig.VertexCount() == figure::RHOMBUS_ANGLES; });
+    sum = v.Summarize();
+    EXPECT_EQ(sum.count, 1);
+    EXPECT_EQ(sum.rhombi, 0);
+    EXPECT_DOUBLE_EQ(sum.total_area, pent.Area());
+
+    v.Clear();
+    EXPECT_EQ(v.Summarize().count, 0);
+
+    vector::Vector with_null = {&pent, nullptr, &trap};
+    with_null.EnableSummary();
+    EXPECT_EQ(with_null.Summarize().count, 2);
+    with_null.Erase(1);
+    EXPECT_EQ(with_null.Summarize().trapezoids, 1);
+}
+
+#ifdef VECTOR_AGGREGATES
+TEST(VectorTest, SummaryRescansOnlyEditedFigures) {
+    struct CountedSquare : figure::Figure {
+        mutable int area_calls = 0;
+
+        figure::Point Center() const override { return {0.5, 0.5}; }
+        double Area() const override { ++area_calls; return 1.0; }
+        int VertexCount() const override { return 4; }
+        figure::Point GetVertex(int idx) const override { return {double(idx == 1 || idx == 2), double(idx >= 2)}; }
+        operator double() override { return Area(); }
+    };
+
+    CountedSquare square;
+    figure::Rhombus rh({0,0}, {2,1}, {0,2}, {-2,1});
+    figure::Rhombus outside({0,0}, {2,1}, {0,2}, {-2,1});
+    EXPECT_NEAR(outside.Area(), 4.0, 1e-9);
+
+    vector::Vector v;
+    v.EnableSummary();
+    v.PushBack(&square);
+    v.PushBack(&rh);
+    EXPECT_NEAR(v.Summarize().total_area, 5.0, 1e-9);
+    const int calls = square.area_calls;
+
+    outside.SetVertex(2, {0, 4});
+    EXPECT_NEAR(v.Summarize().total_area, 5.0, 1e-9);
+    EXPECT_EQ(square.area_calls, calls);
+
+    rh.SetVertex(2, {0, 4});
+    EXPECT_NEAR(v.Summarize().total_area, 9.0, 1e-9);
+    EXPECT_GT(square.area_calls, calls);
+
+    rh.SetVertex(2, {0, 2});
+    std::vector<std::thread> readers;
+    std::vector<double> totals(8);
+    for (size_t t = 0; t < totals.size(); ++t) {
+        readers.emplace_back([&v, &totals, t] { totals[t] = v.Summarize().total_area; });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    for (double total : totals) {
+        EXPECT_NEAR(total, 5.0, 1e-9);
+    }
+}
+#endif
+
+TEST(CacheTest, MutationInvalidatesArea) {
+    figure::Rhombus r({0,0}, {2,1}, {0,2}, {-2,1});
+    EXPECT_NEAR(r.Area(), 4.0, 1e-9);
+    EXPECT_DOUBLE_EQ(r.Center().y, 1.0);
+
+    r.SetVertex(2, {0, 4});
+    EXPECT_NEAR(r.Area(), 8.0, 1e-9);
+    EXPECT_DOUBLE_EQ(r.Center().y, 1.5);
+    EXPECT_THROW(r.SetVertex(4, {0, 0}), std::out_of_range);
+
+    r = figure::Rhombus({0,0}, {1,0}, {1,1}, {0,1});
+    EXPECT_NEAR(r.Area(), 1.0, 1e-9);
+
+    std::istringstream input("0 0 2 0 2 2 0 2");
+    input >> r;
+    EXPECT_NEAR(r.Area(), 4.0, 1e-9);
+    EXPECT_DOUBLE_EQ(r.Center().x, 1.0);
+
+    figure::Trapezoid t({0,0}, {4,0}, {3,3}, {1,3});
+    figure::Trapezoid copy(t);
+    EXPECT_DOUBLE_EQ(copy.Area(), t.Area());
+    t.SetVertex(0, {-1, 0});
+    EXPECT_NEAR(t.Area(), 10.5, 1e-9);
+    EXPECT_NEAR(copy.Area(), 9.0, 1e-9);
+}
+
+TEST(RTreeTest, QueriesMatchLinearScan) {
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<double> coord(-500.0, 500.0);
+    std::uniform_real_distribution<double> size(0.5, 5.0);
+
+    std::vector<figure::Rhombus> figures;
+    for (int i = 0; i < 3000; ++i) {
+        const double x = coord(gen), y = coord(gen), s = size(gen);
+        figures.emplace_back(figure::Point(x, y), figure::Point(x + 2 * s, y + s),
+                             figure::Point(x, y + 2 * s), figure::Point(x - 2 * s, y + s));
+    }
+
+    vector::Vector v;
+    for (size_t i = 0; i < 2000; ++i) {
+        v.PushBack(&figures[i]);
+    }
+    spatial::RTree tree(v);
+    for (size_t i = 2000; i < figures.size(); ++i) {
+        tree.Insert(&figures[i]);
+    }
+    for (size_t i = 0; i < figures.size(); i += 3) {
+        EXPECT_TRUE(tree.Erase(&figures[i]));
+    }
+    EXPECT_FALSE(tree.Erase(&figures[0]));
+    EXPECT_EQ(tree.Size(), 2000);
+
+    auto sorted = [](std::vector<const figure::Figure*> res) {
+        std::sort(res.begin(), res.end());
+        return res;
+    };
+
+    for (int q = 0; q < 50; ++q) {
+        const figure::Point point(coord(gen), coord(gen));
+        const figure::Box box(point.x, point.y, point.x + 40, point.y + 25);
+
+        std::vector<const figure::Figure*> in_range, at_point;
+        const figure::Figure* nearest = nullptr;
+        double best = 1e300;
+        for (size_t i = 0; i < figures.size(); ++i) {
+            if (i % 3 == 0) {
+                continue;
+            }
+            if (figure::Bounds(figures[i]).Overlaps(box)) {
+                in_range.push_back(&figures[i]);
+            }
+            if (figure::Contains(figures[i], point)) {
+                at_point.push_back(&figures[i]);
+            }
+            if (figure::Distance(figures[i], point) < best) {
+                best = figure::Distance(figures[i], point);
+                nearest = &figures[i];
+            }
+        }
+
+        EXPECT_EQ(sorted(tree.Range(box)), sorted(in_range));
+        EXPECT_EQ(sorted(tree.AtPoint(point)), sorted(at_point));
+        EXPECT_DOUBLE_EQ(figure::Distance(*tree.Nearest(point), point), figure::Distance(*nearest, point));
+    }
+
+    tree.Clear();
+    EXPECT_TRUE(tree.IsEmpty());
+    EXPECT_EQ(tree.Nearest({0, 0}), nullptr);
+}
+
+TEST(FigureTest, ContainsAndBounds) {
+    figure::Rhombus r({0,0}, {2,1}, {0,2}, {-2,1});
+    EXPECT_TRUE(figure::Contains(r, {0, 1}));
+    EXPECT_TRUE(figure::Contains(r, {2, 1}));
+    EXPECT_FALSE(figure::Contains(r, {1.5, 1.8}));
+    EXPECT_NEAR(figure::Distance(r, {4, 1}), 2.0, 1e-9);
+
+    figure::Box box = figure::Bounds(r);
+    EXPECT_DOUBLE_EQ(box.min_x, -2.0);
+    EXPECT_DOUBLE_EQ(box.max_y, 2.0);
+}
+
+TEST(StoreTest, BinaryRoundTrip) {
+    store::Store s;
+    for (int i = 0; i < 700; ++i) {
+        s.PushBack(figure::Pentagon());
+        s.PushBack(figure::Rhombus({0.0 + i, 0}, {2.0 + i, 1}, {0.0 + i, 2}, {-2.0 + i, 1}));
+        if (i % 2 == 0) {
+            s.PushBack(figure::Trapezoid({0, 0.0 + i}, {4, 0.0 + i}, {3, 3.0 + i}, {1, 3.0 + i}));
+        }
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "figures_store_test.bin").string();
+    s.WriteBinary(path);
+
+    store::Store mapped = store::Store::MapBinary(path);
+    EXPECT_TRUE(mapped.IsMapped());
+    EXPECT_EQ(mapped.PentagonCount(), 700);
+    EXPECT_EQ(mapped.RhombusCount(), 700);
+    EXPECT_EQ(mapped.TrapezoidCount(), 350);
+    EXPECT_EQ(mapped.TotalArea(), s.TotalArea());
+    EXPECT_EQ(mapped.Areas(), s.Areas());
+
+    mapped.PushBack(figure::Pentagon());
+    EXPECT_EQ(mapped.PentagonCount(), 701);
+    EXPECT_EQ(mapped.Centers()[700], figure::Pentagon().Center());
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+    EXPECT_THROW(store::Store::MapBinary(path), exceptions::FormatException);
+    std::filesystem::remove(path);
+    EXPECT_THROW(store::Store::MapBinary(path), exceptions::StorageException);
+}
+
+TEST(ParserTest, ParsesFigures) {
+    const std::string text =
+        "# scene\n"
+        "trapezoid 0 0 4 0 3 3 1 3\n"
+        "\n"
+        "rhombus (0, 0)(2, 1)(0, 2)(-2, 1)\n"
+        "pentagon 1 0 0.309 0.951 -0.809 0.588 -0.809 -0.588 0.309 -0.951  # unit\n";
+
+    store::Store s = parser::Parse(text);
+    EXPECT_EQ(s.TrapezoidCount(), 1);
+    EXPECT_EQ(s.RhombusCount(), 1);
+    EXPECT_EQ(s.PentagonCount(), 1);
+    EXPECT_NEAR(s.TotalArea(), 9.0 + 4.0 + figure::Pentagon().Area(), 1e-9);
+}
+
+TEST(ParserTest, ParallelChunksMatchSerial) {
+    std::string text;
+    for (int i = 0; i < 5000; ++i) {
+        text += "rhombus " + std::to_string(i) + " 0 " + std::to_string(i + 2) + " 1 " + std::to_string(i) +
+                " 2 " + std::to_string(i - 2) + " 1\n";
+        text += "trapezoid 0 " + std::to_string(i) + " 4 " + std::to_string(i) + " 3 " + std::to_string(i + 3) +
+                " 1 " + std::to_string(i + 3) + "\n";
+    }
+
+    store::Store serial = parser::Parse(text);
+    store::Store parallel = parser::Parse(text, 7);
+    EXPECT_EQ(serial.Size(), 10000);
+    EXPECT_EQ(parallel.Areas(), serial.Areas());
+    EXPECT_EQ(parallel.Centers().back(), serial.Centers().back());
+
+    std::string broken = text + "rhombus 0 0 1 0 5 5 0 1\n" + text;
+    for (size_t threads : {1, 3, 8}) {
+        try {
+            parser::Parse(broken, threads);
+            FAIL() << "expected ParseException";
+        } catch (const exceptions::ParseException& e) {
+            EXPECT_EQ(e.Line(), 10001);
+        }
+    }
+}
+
+TEST(ParserTest, ReportsErrors) {
+    auto line_of = [](const std::string& text) -> size_t {
+        try {
+            parser::Parse(text);
+        } catch (const exceptions::ParseException& e) {
+            return e.Line();
+        }
+        return 0;
+    };
+
+    EXPECT_EQ(line_of("hexagon 0 0\n"), 1);
+    EXPECT_EQ(line_of("\nrhombus 0 0 2 1 0 2\n"), 2);
+    EXPECT_EQ(line_of("rhombus 0 0 2 1 0 2 -2 x\n"), 1);
+    EXPECT_EQ(line_of("rhombus 0 0 2 1 0 2 -2 1 7\n"), 1);
+    EXPECT_EQ(line_of("trapezoid 0 0 4 0 3 3 1 3\ntrapezoid 0 0 0 0 3 3 1 3"), 2);
+    EXPECT_THROW(parser::ParseFile("/nonexistent/figures.txt"), exceptions::StorageException);
+}
+
+TEST(ParserTest, RejectsNonFiniteAcrossChunks) {
+    const std::string good = "trapezoid 0 0 4 0 3 3 1 3\n";
+    for (const std::string bad : {"trapezoid 0 0 inf 0 3 3 1 3\n", "rhombus 0 0 2 1 0 nan -2 1\n",
+                                  "pentagon 1 0 0 1 -1 0 0 -1 -INF 0.5\n", "trapezoid 0 0 4 0 3 3 1 infinity\n"}) {
+        for (size_t bad_line : {1, 2, 17, 40, 64}) {
+            std::string text;
+            for (size_t line = 1; line <= 64; ++line) {
+                text += line == bad_line || line == 64 ? bad : good;
+            }
+
+            for (size_t threads : {1, 2, 3, 5, 8}) {
+                try {
+                    parser::Parse(text, threads);
+                    FAIL() << "expected ParseException";
+                } catch (const exceptions::ParseException& e) {
+                    EXPECT_EQ(e.Line(), bad_line) << bad << threads << " threads";
+                    EXPECT_NE(std::string(e.what()).find("non-finite"), std::string::npos) << e.what();
+                }
+            }
+        }
+    }
+}
+
+TEST(PolygonTest, GenericTriangle) {
+    figure::Polygon<3> tri({figure::Point(0, 0), figure::Point(4, 0), figure::Point(0, 3)});
+    figure::Polygon<3> same({figure::Point(0, 0), figure::Point(4, 0), figure::Point(0, 3 + figure::EPS / 2)});
+    figure::Polygon<3> flat({figure::Point(0, 0), figure::Point(1, 1), figure::Point(2, 2)});
+
+    EXPECT_EQ(tri.VertexCount(), 3);
+    EXPECT_DOUBLE_EQ(tri.Area(), 6.0);
+    EXPECT_NEAR(tri.Center().x, 4.0 / 3, figure::EPS);
+    EXPECT_NEAR(tri.Center().y, 1.0, figure::EPS);
+    EXPECT_TRUE(tri.Equals(same));
+    EXPECT_TRUE(tri.IsValid());
+    EXPECT_FALSE(flat.IsValid());
+
+    tri.SetVertex(2, figure::Point(4, 0));
+    EXPECT_FALSE(tri.IsValid());
+    EXPECT_THROW(tri.GetVertex(3), std::out_of_range);
+}
+
+TEST(RankingTest, TopKSortAndPercentiles) {
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> dist(0, 999);
+    std::vector<double> keys(100000);
+    for (double& key : keys) {
+        key = dist(gen);
+    }
+
+    std::vector<size_t> expected(keys.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        expected[i] = i;
+    }
+    std::stable_sort(expected.begin(), expected.end(), [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+    EXPECT_EQ(ranking::SortedOrder(keys, 4), expected);
+    EXPECT_EQ(ranking::SortedOrder(keys, 1), expected);
+
+    std::vector<size_t> top = ranking::TopK(keys, 10);
+    ASSERT_EQ(top.size(), 10);
+    for (size_t i = 0; i < top.size(); ++i) {
+        EXPECT_EQ(keys[top[i]], keys[expected[expected.size() - 1 - i]]);
+    }
+    EXPECT_EQ(ranking::TopK({1, 3, 3, 2}, 10), (std::vector<size_t>{1, 2, 3, 0}));
+
+    EXPECT_DOUBLE_EQ(ranking::Percentile({5, 1, 4, 2, 3}, 50), 3.0);
+    EXPECT_DOUBLE_EQ(ranking::Percentile({5, 1, 4, 2, 3}, 90), 4.6);
+    EXPECT_DOUBLE_EQ(ranking::Percentile({5, 1, 4, 2, 3}, 100), 5.0);
+    EXPECT_THROW(ranking::Percentile({}, 50), std::invalid_argument);
+    EXPECT_THROW(ranking::Percentile({1}, 101), std::invalid_argument);
+}
+
+TEST(RankingTest, ContainersAgree) {
+    figure::Rhombus small({0,0}, {1,1}, {0,2}, {-1,1});
+    figure::Trapezoid large({0,0}, {4,0}, {3,3}, {1,3});
+    figure::Pentagon pent;
+
+    vector::Vector vec;
+    vec.PushBack(&small);
+    vec.PushBack(&large);
+    vec.PushBack(&pent);
+    vector::VariantVector variants{small, large, pent};
+    store::Store soa;
+    soa.PushBack(pent);
+    soa.PushBack(small);
+    soa.PushBack(large);
+
+    EXPECT_EQ(vec.TopK(2), (std::vector<size_t>{1, 2}));
+    EXPECT_EQ(variants.TopK(2), (std::vector<size_t>{1, 2}));
+    EXPECT_EQ(soa.TopK(1), (std::vector<size_t>{2}));
+    EXPECT_EQ(vec.SortByArea(), (std::vector<size_t>{0, 2, 1}));
+    EXPECT_EQ(variants.SortByArea(2), (std::vector<size_t>{0, 2, 1}));
+    EXPECT_EQ(soa.SortByArea(), (std::vector<size_t>{1, 0, 2}));
+    EXPECT_DOUBLE_EQ(vec.AreaPercentile(50), pent.Area());
+    EXPECT_DOUBLE_EQ(variants.AreaPercentile(50), pent.Area());
+    EXPECT_DOUBLE_EQ(soa.AreaPercentile(50), pent.Area());
+    EXPECT_DOUBLE_EQ(vec.AreaPercentile(100), 9.0);
+}
+
+TEST(CollisionTest, SweepMatchesBruteForce) {
+    figure::Rhombus diamond({0,0}, {2,1}, {0,2}, {-2,1});
+    figure::Trapezoid corner({1.6,1.6}, {3,1.6}, {3,3}, {1.6,3});
+    figure::Trapezoid touching({2,0}, {4,0}, {4,2}, {2,2});
+    EXPECT_TRUE(figure::Bounds(diamond).Overlaps(figure::Bounds(corner)));
+    EXPECT_FALSE(spatial::Overlaps(diamond, corner));
+    EXPECT_TRUE(spatial::Overlaps(diamond, touching));
+
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<double> offset(0.0, 60.0);
+    std::vector<figure::Pentagon> pents;
+    std::vector<figure::Rhombus> rhombi;
+    for (int i = 0; i < 300; ++i) {
+        const double dx = offset(gen), dy = offset(gen);
+        pents.emplace_back(figure::Point(dx + 1.0, dy), figure::Point(dx + 0.309, dy + 0.951),
+                           figure::Point(dx - 0.809, dy + 0.588), figure::Point(dx - 0.809, dy - 0.588),
+                           figure::Point(dx + 0.309, dy - 0.951));
+        const double rx = offset(gen), ry = offset(gen);
+        rhombi.emplace_back(figure::Point(rx, ry), figure::Point(rx + 2, ry + 1), figure::Point(rx, ry + 2),
+                            figure::Point(rx - 2, ry + 1));
+    }
+
+    vector::Vector v;
+    for (int i = 0; i < 300; ++i) {
+        v.PushBack(&pents[i]);
+        v.PushBack(&rhombi[i]);
+    }
+
+    std::vector<spatial::IndexPair> expected;
+    for (size_t i = 0; i < v.Size(); ++i) {
+        for (size_t j = i + 1; j < v.Size(); ++j) {
+            if (spatial::Overlaps(v[i], v[j])) {
+                expected.emplace_back(i, j);
+            }
+        }
+    }
+
+    std::vector<spatial::IndexPair> serial = spatial::OverlappingPairs(v);
+    std::vector<spatial::IndexPair> parallel = spatial::OverlappingPairs(v, 4);
+    EXPECT_EQ(serial, parallel);
+
+    std::sort(serial.begin(), serial.end());
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(serial, expected);
+}
+
+TEST(KernelsTest, ContainsMatchesScalar) {
+    figure::Pentagon pent;
+    figure::Rhombus rh({0,0}, {2,1}, {0,2}, {-2,1});
+    figure::Trapezoid trap({0,0}, {4,0}, {3,3}, {1,3});
+    figure::Polygon<3> tri({figure::Point(0, 0), figure::Point(4, 0), figure::Point(0, 3)});
+
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> coord(-3.0, 5.0);
+    std::vector<figure::Point> points = {{0, 0}, {1, 0.5}, {2, 0}, {1, 3}, {0.309, 0.951}};
+    for (int i = 0; i < 1003; ++i) {
+        points.emplace_back(coord(gen), coord(gen));
+    }
+
+    auto expect_masks = [&](const std::vector<uint64_t>& masks, auto&& inside) {
+        ASSERT_EQ(masks.size(), (points.size() + 63) / 64);
+        for (size_t j = 0; j < points.size(); ++j) {
+            EXPECT_EQ((masks[j / 64] >> (j % 64)) & 1, inside(points[j]) ? 1u : 0u) << "point " << j;
+        }
+    };
+
+    const figure::Figure* figures[] = {&pent, &rh, &trap, &tri};
+    for (const figure::Figure* fig : figures) {
+        expect_masks(fig->Contains(points), [&](const figure::Point& p) { return figure::Contains(*fig, p); });
+    }
+
+    vector::Vector vec{&pent, &rh, &trap};
+    vector::VariantVector variants{pent, rh, trap};
+    store::Store soa(vec);
+    auto any = [&](const figure::Point& p) {
+        return figure::Contains(pent, p) || figure::Contains(rh, p) || figure::Contains(trap, p);
+    };
+    expect_masks(vec.Contains(points), any);
+    expect_masks(variants.Contains(points), any);
+    expect_masks(soa.Contains(points), any);
+
+    vector::Vector scene;
+    std::vector<figure::Rhombus> rhombi;
+    std::vector<figure::Trapezoid> trapezoids;
+    rhombi.reserve(100);
+    trapezoids.reserve(100);
+    for (int i = 0; i < 100; ++i) {
+        const double x = coord(gen), y = coord(gen);
+        rhombi.emplace_back(figure::Point(x, y), figure::Point(x + 0.4, y + 0.2), figure::Point(x, y + 0.4),
+                            figure::Point(x - 0.4, y + 0.2));
+        trapezoids.emplace_back(figure::Point(y, x), figure::Point(y + 0.8, x), figure::Point(y + 0.6, x + 0.6),
+                                figure::Point(y + 0.2, x + 0.6));
+        scene.PushBack(&rhombi.back());
+        scene.PushBack(&trapezoids.back());
+    }
+    points.push_back(rhombi[7].GetVertex(1));
+    points.push_back(trapezoids[3].GetVertex(0));
+    EXPECT_EQ(store::Store(scene).Contains(points), scene.Contains(points));
+}
+
+TEST(StoreTest, IndexResolvesToFigure) {
+    figure::Trapezoid trap({0,0}, {4,0}, {3,3}, {1,3});
+    figure::Rhombus rh({0,0}, {2,1}, {0,2}, {-2,1});
+    figure::Pentagon pent;
+
+    store::Store soa;
+    soa.PushBack(trap);
+    soa.PushBack(rh);
+    soa.PushBack(pent);
+
+    const size_t largest = soa.TopK(1)[0];
+    EXPECT_EQ(largest, 2);
+    ASSERT_TRUE(std::holds_alternative<figure::Trapezoid>(soa.At(largest)));
+    EXPECT_EQ(std::get<figure::Trapezoid>(soa.At(largest)), trap);
+    EXPECT_EQ(std::get<figure::Pentagon>(soa.At(0)), pent);
+    EXPECT_EQ(std::get<figure::Rhombus>(soa.At(1)), rh);
+    EXPECT_DOUBLE_EQ(vector::Area(soa.At(1)), soa.Areas()[1]);
+    EXPECT_THROW(soa.At(3), std::out_of_range);
+}
+
+TEST(RTreeTest, EraseUsesInsertedBox) {
+    std::vector<figure::Rhombus> figures;
+    for (int i = 0; i < 200; ++i) {
+        const double x = (i % 20) * 10.0, y = (i / 20) * 10.0;
+        figures.emplace_back(figure::Point(x, y), figure::Point(x + 2, y + 1),
+                             figure::Point(x, y + 2), figure::Point(x - 2, y + 1));
+    }
+
+    spatial::RTree tree;
+    for (auto& fig : figures) {
+        tree.Insert(&fig);
+    }
+
+    for (size_t i = 0; i < figures.size(); i += 2) {
+        for (int k = 0; k < figures[i].VertexCount(); ++k) {
+            figure::Point p = figures[i].GetVertex(k);
+            figures[i].SetVertex(k, {p.x + 1e4, p.y - 1e4});
+        }
+    }
+    for (size_t i = 0; i < figures.size(); i += 2) {
+        EXPECT_TRUE(tree.Erase(&figures[i]));
+    }
+    EXPECT_FALSE(tree.Erase(&figures[0]));
+    EXPECT_EQ(tree.Size(), figures.size() / 2);
+    EXPECT_EQ(tree.Range(figure::Box(-1e5, -1e5, 1e5, 1e5)).size(), figures.size() / 2);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();